@@ -0,0 +1,293 @@
+/*
+  ==============================================================================
+
+    Benchmarks for the converter and the geometry it emits.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SvgParser.h"
+#include "LayeredIconWriter.h"
+#include "SvgLoader.h"
+#include <iostream>
+#include <thread>
+
+//==============================================================================
+//! @brief a few icons with arcs, quadratics and cubics, used when no svgs are given
+static const char* const sampleIcons[] = {
+    R"(<svg viewBox="0 0 24 24"><path d="M12 21.35l-1.45-1.32C5.4 15.36 2 12.28 2 8.5 2 5.42 4.42 3 7.5 3c1.74 0 3.41.81 4.5 2.09C13.09 3.81 14.76 3 16.5 3 19.58 3 22 5.42 22 8.5c0 3.78-3.4 6.86-8.55 11.54L12 21.35z"/></svg>)",
+    R"(<svg viewBox="0 0 24 24"><circle cx="12" cy="12" r="10"/><circle cx="12" cy="12" r="6"/><rect x="4" y="4" width="16" height="16" rx="4"/></svg>)",
+    R"(<svg viewBox="0 0 24 24"><path d="M3 12Q6 2 12 12T21 12M3 18Q6 8 12 18T21 18M4 6a8 4 0 1 0 16 0a8 4 0 1 0-16 0"/></svg>)",
+    R"(<svg viewBox="0 0 24 24"><rect width="24" height="24" rx="5" fill="#2d6cdf"/><circle cx="12" cy="10" r="5" fill="#fff" fill-opacity="0.9"/><path d="M5 21c1-4 4-6 7-6s6 2 7 6" style="fill:none;stroke:#ffd400;stroke-width:2;stroke-linecap:round"/></svg>)",
+    R"(<svg viewBox="0 0 24 24"><path d="M12 2C6.48 2 2 6.48 2 12s4.48 10 10 10 10-4.48 10-10S17.52 2 12 2zm0 18c-4.41 0-8-3.59-8-8s3.59-8 8-8 8 3.59 8 8-3.59 8-8 8zm-1-13h2v6h-2zm0 8h2v2h-2z"/></svg>)",
+};
+
+//! @brief returns the svgs named on the command line, or the sample icons
+static StringArray getIcons(const StringArray& args)
+{
+    StringArray icons;
+    
+    for (const auto& arg: args)
+    {
+        File file = File::getCurrentWorkingDirectory().getChildFile(arg);
+        
+        if (file.isDirectory())
+            for (const auto& child: file.findChildFiles(File::findFiles, true, "*.svg"))
+                icons.add(child.loadFileAsString());
+        else if (file.existsAsFile())
+            icons.add(file.loadFileAsString());
+    }
+    
+    if (icons.isEmpty())
+        for (auto* icon: sampleIcons)
+            icons.add(icon);
+    
+    return icons;
+}
+
+//! @brief returns the number of verbs in a path
+static int countElements(const Path& path)
+{
+    int numElements = 0;
+    for (Path::Iterator it(path); it.next();)
+        ++numElements;
+    
+    return numElements;
+}
+
+//! @brief fills a path into a software image repeatedly and returns the mean time per fill
+static double getNanosecondsPerFill(const Path& path, int size, int iterations)
+{
+    Image image(Image::ARGB, size, size, true, SoftwareImageType());
+    Graphics g(image);
+    g.setColour(Colours::white);
+    
+    // The path is normalised to the render size, so one pass warms up the edge table allocations
+    g.fillPath(path);
+    
+    auto start = Time::getHighResolutionTicks();
+    for (int i = 0; i < iterations; ++i)
+        g.fillPath(path);
+    auto end = Time::getHighResolutionTicks();
+    
+    return Time::highResolutionTicksToSeconds(end - start) * 1.0e9 / iterations;
+}
+
+//! @brief compares filling curves against filling lines pre-flattened for the render size
+static void benchmarkFlattening(const StringArray& icons)
+{
+    const int sizes[] = {16, 24, 48, 96};
+    const int iterations = 2000;
+    
+    std::cout << "Fill time, curves vs flattened at 0.2px" << std::endl;
+    std::cout << "size   curve ns   flat ns   speedup   curve verbs   flat verbs" << std::endl;
+    
+    for (auto size: sizes)
+    {
+        double curveTime = 0.0, flatTime = 0.0;
+        int curveElements = 0, flatElements = 0;
+        
+        for (const auto& icon: icons)
+        {
+            SvgParser parser;
+            parser.setNormalisation(SvgParser::Normalisation::fit, (float) size, (float) size);
+            
+            Path curves;
+            parser.parse(icon, curves);
+            
+            parser.setFlattening((float) size);
+            Path flat;
+            parser.parse(icon, flat);
+            
+            curveTime += getNanosecondsPerFill(curves, size, iterations);
+            flatTime += getNanosecondsPerFill(flat, size, iterations);
+            curveElements += countElements(curves);
+            flatElements += countElements(flat);
+        }
+        
+        std::cout << String(size).paddedLeft(' ', 4)
+                  << String(curveTime / icons.size(), 0).paddedLeft(' ', 11)
+                  << String(flatTime / icons.size(), 0).paddedLeft(' ', 10)
+                  << String(curveTime / jmax(1.0, flatTime), 2).paddedLeft(' ', 9) << "x"
+                  << String(curveElements).paddedLeft(' ', 13)
+                  << String(flatElements).paddedLeft(' ', 13) << std::endl;
+    }
+}
+
+//! @brief returns the mean time of a function over a number of calls
+template <typename Function>
+static double getNanosecondsPerCall(int iterations, Function&& function)
+{
+    auto start = Time::getHighResolutionTicks();
+    for (int i = 0; i < iterations; ++i)
+        function();
+    auto end = Time::getHighResolutionTicks();
+    
+    return Time::highResolutionTicksToSeconds(end - start) * 1.0e9 / iterations;
+}
+
+//! @brief compares loading and drawing layer tables against parsing the svg into a Drawable at runtime
+static void benchmarkLayers(const StringArray& icons)
+{
+    const int size = 48;
+    const int loadIterations = 200;
+    const int drawIterations = 2000;
+    
+    Image image(Image::ARGB, size, size, true, SoftwareImageType());
+    Graphics g(image);
+    const auto area = image.getBounds().toFloat();
+    
+    double drawableLoad = 0.0, layersLoad = 0.0, drawableDraw = 0.0, layersDraw = 0.0;
+    int numLayers = 0, numCompared = 0;
+    
+    for (const auto& svg: icons)
+    {
+        SvgParser parser;
+        std::vector<SvgParser::Layer> layers;
+        parser.parse(svg, layers);
+        
+        auto table = LayeredIconWriter::build(layers);
+        LayeredIcon icon(table.getData(), table.getSize());
+        
+        auto xml = XmlDocument::parse(svg);
+        auto drawable = xml != nullptr ? Drawable::createFromSVG(*xml) : nullptr;
+        
+        if (drawable == nullptr || layers.empty())
+            continue;
+        
+        // Loading a Drawable includes parsing the xml, which a table doesn't need
+        drawableLoad += getNanosecondsPerCall(loadIterations, [&] {
+            auto document = XmlDocument::parse(svg);
+            Drawable::createFromSVG(*document);
+        });
+        layersLoad += getNanosecondsPerCall(loadIterations, [&] { LayeredIcon(table.getData(), table.getSize()); });
+        
+        drawable->drawWithin(g, area, RectanglePlacement::centred, 1.0f);
+        drawableDraw += getNanosecondsPerCall(drawIterations, [&] {
+            drawable->drawWithin(g, area, RectanglePlacement::centred, 1.0f);
+        });
+        
+        icon.drawWithin(g, area);
+        layersDraw += getNanosecondsPerCall(drawIterations, [&] { icon.drawWithin(g, area); });
+        
+        numLayers += icon.getNumLayers();
+        ++numCompared;
+    }
+    
+    if (numCompared == 0)
+        return;
+    
+    std::cout << "Coloured icons, Drawable::createFromSVG vs layer tables at " << size << "px, "
+              << String(numLayers / (double) numCompared, 1) << " layers per icon" << std::endl;
+    std::cout << "          drawable ns   layers ns   speedup" << std::endl;
+    
+    auto printRow = [&](const String& name, double drawableTime, double layersTime) {
+        std::cout << name.paddedRight(' ', 6)
+                  << String(drawableTime / numCompared, 0).paddedLeft(' ', 15)
+                  << String(layersTime / numCompared, 0).paddedLeft(' ', 12)
+                  << String(drawableTime / jmax(1.0, layersTime), 1).paddedLeft(' ', 9) << "x" << std::endl;
+    };
+    
+    printRow("load", drawableLoad, layersLoad);
+    printRow("draw", drawableDraw, layersDraw);
+}
+
+//! @brief compares loading svgs at runtime with SvgLoader against Drawable::createFromSVG
+static void benchmarkLoader(const StringArray& icons)
+{
+    const int iterations = 200;
+    
+    std::vector<MemoryBlock> files;
+    for (const auto& svg: icons)
+        files.emplace_back(svg.toRawUTF8(), svg.getNumBytesAsUTF8());
+    
+    double drawableTime = 0.0, pathTime = 0.0, iconTime = 0.0;
+    SvgLoader loader;
+    
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        const auto& data = files[i];
+        const auto& svg = icons[(int) i];
+        
+        drawableTime += getNanosecondsPerCall(iterations, [&] {
+            if (auto xml = XmlDocument::parse(svg))
+                Drawable::createFromSVG(*xml);
+        });
+        
+        pathTime += getNanosecondsPerCall(iterations, [&] {
+            Path path;
+            loader.loadPath(data.getData(), data.getSize(), path);
+        });
+        
+        iconTime += getNanosecondsPerCall(iterations, [&] {
+            LayeredIcon icon;
+            loader.loadIcon(data.getData(), data.getSize(), icon);
+        });
+    }
+    
+    const auto numIcons = (double) jmax((size_t) 1, files.size());
+    std::cout << "Runtime loading, mean per svg" << std::endl;
+    std::cout << "                                 ns   vs drawable" << std::endl;
+    
+    auto printRow = [&](const String& name, double time) {
+        std::cout << name.paddedRight(' ', 28) << String(time / numIcons, 0).paddedLeft(' ', 9)
+                  << String(drawableTime / jmax(1.0, time), 1).paddedLeft(' ', 13) << "x" << std::endl;
+    };
+    
+    printRow("Drawable::createFromSVG", drawableTime);
+    printRow("SvgLoader::loadPath", pathTime);
+    printRow("SvgLoader::loadIcon", iconTime);
+    
+    // Loaders share nothing between calls, so throughput should scale with the threads
+    const int numThreads = jmax(1, (int) std::thread::hardware_concurrency());
+    const int rounds = 20;
+    
+    auto getLoadsPerSecond = [&](int threads) {
+        std::vector<std::thread> workers;
+        auto start = Time::getHighResolutionTicks();
+        
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&] {
+                for (int round = 0; round < rounds; ++round)
+                {
+                    for (const auto& data: files)
+                    {
+                        LayeredIcon icon;
+                        loader.loadIcon(data.getData(), data.getSize(), icon);
+                    }
+                }
+            });
+        }
+        
+        for (auto& worker: workers)
+            worker.join();
+        
+        auto seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+        return threads * rounds * (double) files.size() / jmax(1.0e-9, seconds);
+    };
+    
+    const double single = getLoadsPerSecond(1);
+    const double parallel = getLoadsPerSecond(numThreads);
+    std::cout << "loadIcon on 1 thread " << String(single, 0) << "/s, on " << numThreads << " threads "
+              << String(parallel, 0) << "/s (" << String(parallel / jmax(1.0, single), 1) << "x)" << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // Drawables are components, which need the message manager
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    
+    auto icons = getIcons(StringArray(argv + 1, argc - 1));
+    std::cout << "Benchmarking " << icons.size() << " icons" << std::endl << std::endl;
+    
+    benchmarkFlattening(icons);
+    std::cout << std::endl;
+    benchmarkLayers(icons);
+    std::cout << std::endl;
+    benchmarkLoader(icons);
+    
+    return 0;
+}
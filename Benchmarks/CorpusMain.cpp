@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    Generates a synthetic svg corpus from a seed, to disk or in memory.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SvgCorpusGenerator.h"
+#include <iostream>
+
+//==============================================================================
+//! @brief reads a size such as 512, 64k, 10m or 2g
+static int64 parseByteCount(const String& text)
+{
+    const auto suffix = text.trim().getLastCharacter();
+    const auto value = text.trim().getLargeIntValue();
+    
+    switch (CharacterFunctions::toLowerCase(suffix))
+    {
+        case 'k': return value << 10;
+        case 'm': return value << 20;
+        case 'g': return value << 30;
+        default: return value;
+    }
+}
+
+//! @brief reads the generator options from the command line, keeping the defaults for any not given
+static SvgCorpusGenerator::Options getOptions(const ArgumentList& args)
+{
+    SvgCorpusGenerator::Options options;
+    
+    auto getInt = [&](const char* option, int value) {
+        return args.containsOption(option) ? args.getValueForOption(option).getIntValue() : value;
+    };
+    auto getProbability = [&](const char* option, float value) {
+        return args.containsOption(option) ? jlimit(0.0f, 1.0f, args.getValueForOption(option).getFloatValue()) : value;
+    };
+    
+    if (args.containsOption("--seed"))
+        options.seed = args.getValueForOption("--seed").getLargeIntValue();
+    if (args.containsOption("--bytes"))
+        options.targetBytes = parseByteCount(args.getValueForOption("--bytes"));
+    if (args.containsOption("--commands"))
+    {
+        auto range = args.getValueForOption("--commands");
+        options.minCommands = jmax(0, range.upToFirstOccurrenceOf(":", false, false).getIntValue());
+        options.maxCommands = range.containsChar(':') ? range.fromFirstOccurrenceOf(":", false, false).getIntValue()
+                                                      : options.minCommands;
+        options.maxCommands = jmax(options.minCommands, options.maxCommands);
+    }
+    
+    options.numElements = jmax(0, getInt("--elements", options.numElements));
+    options.maxDepth = jmax(0, getInt("--depth", options.maxDepth));
+    options.maxDecimals = jlimit(0, 9, getInt("--decimals", options.maxDecimals));
+    options.groupProbability = getProbability("--groups", options.groupProbability);
+    options.closeProbability = getProbability("--close", options.closeProbability);
+    options.pathProbability = getProbability("--paths", options.pathProbability);
+    options.relativeProbability = getProbability("--relative", options.relativeProbability);
+    options.implicitRepeatProbability = getProbability("--repeats", options.implicitRepeatProbability);
+    options.smoothProbability = getProbability("--smooth", options.smoothProbability);
+    options.arcProbability = getProbability("--arcs", options.arcProbability);
+    options.exponentProbability = getProbability("--exponents", options.exponentProbability);
+    options.compactProbability = getProbability("--compact", options.compactProbability);
+    
+    return options;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    ArgumentList args(argc, argv);
+    
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: Svg2PathCorpus [--out <folder>] [--count <n>] [--seed <n>]" << std::endl
+                  << "         [--elements <n> | --bytes <n[k|m|g]>] [--depth <n>] [--groups <p>] [--close <p>]" << std::endl
+                  << "         [--paths <p>] [--commands <min:max>] [--relative <p>] [--repeats <p>] [--smooth <p>]" << std::endl
+                  << "         [--arcs <p>] [--decimals <n>] [--exponents <p>] [--compact <p>]" << std::endl
+                  << "Writes the files to the folder, or generates them in memory and reports the throughput." << std::endl;
+        return 0;
+    }
+    
+    const SvgCorpusGenerator generator(getOptions(args));
+    const int count = args.containsOption("--count") ? jmax(1, args.getValueForOption("--count").getIntValue()) : 1;
+    
+    int64 totalBytes = 0;
+    auto start = Time::getHighResolutionTicks();
+    
+    if (args.containsOption("--out"))
+    {
+        auto folder = args.getFileForOption("--out");
+        
+        if (folder.createDirectory().failed())
+        {
+            std::cerr << "Could not create " << folder.getFullPathName() << std::endl;
+            return 1;
+        }
+        
+        for (int i = 0; i < count; ++i)
+        {
+            auto file = folder.getChildFile("corpus_" + String(i).paddedLeft('0', 6) + ".svg");
+            file.deleteFile();
+            
+            FileOutputStream out(file);
+            if (out.failedToOpen())
+            {
+                std::cerr << "Could not write " << file.getFullPathName() << std::endl;
+                return 1;
+            }
+            
+            generator.write(i, out);
+            out.flush();
+            totalBytes += out.getPosition();
+        }
+    }
+    else
+    {
+        for (int i = 0; i < count; ++i)
+            totalBytes += generator.generate(i).getNumBytesAsUTF8();
+    }
+    
+    const double seconds = jmax(1.0e-9, Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start));
+    std::cout << "Generated " << count << " files, " << File::descriptionOfSizeInBytes(totalBytes) << " in "
+              << String(seconds, 2) << "s (" << String(totalBytes / seconds / (1024.0 * 1024.0), 1) << " MB/s)" << std::endl;
+    
+    return 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//! @brief the calls of a generated createPath(), read back from the emitted code so they can be replayed
+//! Replaying goes through a switch per call that compiled code doesn't, which makes it a slight
+//! overestimate of what calling the generated function costs.
+class GeneratedCode
+{
+public:
+    explicit GeneratedCode(const String& code)
+    {
+        const StringArray functions{"startNewSubPath", "lineTo", "quadraticTo", "cubicTo", "closeSubPath",
+                                    "addRectangle", "addRoundedRectangle", "addEllipse"};
+        
+        for (const auto& line: StringArray::fromLines(code))
+        {
+            auto name = line.fromFirstOccurrenceOf("path.", false, false).upToFirstOccurrenceOf("(", false, false);
+            const int function = functions.indexOf(name);
+            
+            if (function < 0)
+                continue;
+            
+            Call call{(uint8) function, {}};
+            auto args = StringArray::fromTokens(line.fromFirstOccurrenceOf("(", false, false)
+                                                    .upToLastOccurrenceOf(")", false, false), ",", {});
+            
+            for (int i = 0; i < jmin(6, args.size()); ++i)
+                call.args[i] = args[i].trim().getFloatValue();
+            
+            calls.push_back(call);
+        }
+    }
+    
+    //! @brief builds the path the generated code builds
+    void replay(Path& path) const
+    {
+        for (const auto& call: calls)
+        {
+            const float* a = call.args;
+            
+            switch (call.function)
+            {
+                case 0: path.startNewSubPath(a[0], a[1]); break;
+                case 1: path.lineTo(a[0], a[1]); break;
+                case 2: path.quadraticTo(a[0], a[1], a[2], a[3]); break;
+                case 3: path.cubicTo(a[0], a[1], a[2], a[3], a[4], a[5]); break;
+                case 4: path.closeSubPath(); break;
+                case 5: path.addRectangle(a[0], a[1], a[2], a[3]); break;
+                case 6: path.addRoundedRectangle(a[0], a[1], a[2], a[3], a[4], a[5]); break;
+                case 7: path.addEllipse(a[0], a[1], a[2], a[3]); break;
+                default: break;
+            }
+        }
+    }
+    
+    size_t getNumCalls() const { return calls.size(); }
+    
+private:
+    struct Call
+    {
+        uint8 function;
+        float args[6];
+    };
+    
+    std::vector<Call> calls;
+};
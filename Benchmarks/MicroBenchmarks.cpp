@@ -0,0 +1,406 @@
+/*
+  ==============================================================================
+
+    Microbenchmarks for each stage of the conversion pipeline, with JSON output
+    to archive and diff between builds.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SvgParser.h"
+#include "SvgCorpusGenerator.h"
+#include "AllocationStats.h"
+#include <iostream>
+
+//==============================================================================
+//! @brief forwards to the private stages of SvgParser
+struct SvgParserProbe
+{
+    static int parseNumbers(SvgParser& parser, const String& s)
+    {
+        const SvgParser::TextView view(s);
+        int index = 0, count = 0;
+        float number = 0.0f;
+        
+        while (parser.parseNumber(view, index, number))
+            ++count;
+        
+        return count;
+    }
+    
+    static bool parseSVGPathData(SvgParser& parser, const String& pathData, ShapeData& shape)
+    {
+        return parser.parseSVGPathData(pathData, shape);
+    }
+    
+    static size_t scanDocument(SvgParser& parser, const MemoryBlock& data)
+    {
+        ConversionArena::ScopedConversion conversion;
+        SvgParser::Document document;
+        parser.scanDocument(data.getData(), data.getSize(), document);
+        return document.records.size();
+    }
+    
+    static String f(SvgParser& parser, float value)
+    {
+        return parser.f(value);
+    }
+};
+
+//==============================================================================
+//! @brief one stage timed at one input size
+struct Measurement
+{
+    String name;
+    int size;           // the input size parameter, in the stage's own units
+    int64 bytes;        // the bytes of input one operation reads, 0 where that means nothing
+    int64 iterations;
+    double nanosecondsPerOperation;
+    double megabytesPerSecond;
+    double allocationsPerOperation;
+    double allocatedBytesPerOperation;
+};
+
+//! @brief runs an operation until it has taken at least minSeconds, in several repeats, and keeps
+//! the fastest repeat, which is the one least disturbed by the rest of the system
+template <typename Operation>
+static Measurement measure(const String& name, int size, int64 bytes, double minSeconds, Operation&& operation)
+{
+    operation();
+    
+    // Calibrate the batch size on a doubling count until one batch takes a tenth of the budget
+    int64 batch = 1;
+    while (true)
+    {
+        auto start = Time::getHighResolutionTicks();
+        for (int64 i = 0; i < batch; ++i)
+            operation();
+        
+        if (Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) >= minSeconds / 10.0
+            || batch >= ((int64) 1 << 30))
+            break;
+        
+        batch *= 2;
+    }
+    
+    const int repeats = 5;
+    double best = std::numeric_limits<double>::max();
+    AllocationStats::Counts allocations;
+    
+    for (int repeat = 0; repeat < repeats; ++repeat)
+    {
+        const auto allocationsBefore = AllocationStats::getTotal();
+        auto start = Time::getHighResolutionTicks();
+        
+        for (int64 i = 0; i < batch * 2; ++i)
+            operation();
+        
+        const double seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+        allocations = AllocationStats::getTotal() - allocationsBefore;
+        best = jmin(best, seconds / (double) (batch * 2));
+    }
+    
+    Measurement measurement;
+    measurement.name = name;
+    measurement.size = size;
+    measurement.bytes = bytes;
+    measurement.iterations = batch * 2 * repeats;
+    measurement.nanosecondsPerOperation = best * 1.0e9;
+    measurement.megabytesPerSecond = bytes > 0 ? (double) bytes / best / (1024.0 * 1024.0) : 0.0;
+    measurement.allocationsPerOperation = (double) allocations.allocations / (double) (batch * 2);
+    measurement.allocatedBytesPerOperation = (double) allocations.bytes / (double) (batch * 2);
+    
+    return measurement;
+}
+
+//==============================================================================
+//! @brief returns whitespace and comma separated numbers in the notations svgs use
+static String getNumbers(int count, Random& random)
+{
+    String numbers;
+    for (int i = 0; i < count; ++i)
+    {
+        const float value = (random.nextFloat() - 0.5f) * 200.0f;
+        
+        switch (i % 4)
+        {
+            case 0: numbers << String(value, 3) << " "; break;
+            case 1: numbers << String(roundToInt(value)) << ","; break;
+            case 2: numbers << String::formatted("%.2e", value) << " "; break;
+            default: numbers << String(value, 1) << " "; break;
+        }
+    }
+    
+    return numbers;
+}
+
+//! @brief returns generator options for a corpus of the given number of elements, with every
+//! feature of the path grammar mixed in
+static SvgCorpusGenerator::Options getCorpusOptions(int numElements)
+{
+    SvgCorpusGenerator::Options options;
+    options.numElements = numElements;
+    options.minCommands = 8;
+    options.maxCommands = 8;
+    options.viewBoxSize = 24.0f;
+    options.exponentProbability = 0.05f;
+    options.compactProbability = 0.2f;
+    return options;
+}
+
+//==============================================================================
+static void runBenchmarks(const String& filter, double minSeconds, Array<Measurement>& results)
+{
+    auto shouldRun = [&](const String& name) { return filter.isEmpty() || name.containsIgnoreCase(filter); };
+    auto add = [&](const Measurement& measurement) {
+        results.add(measurement);
+        std::cout << measurement.name.paddedRight(' ', 26) << String(measurement.size).paddedLeft(' ', 8)
+                  << String(measurement.nanosecondsPerOperation, 0).paddedLeft(' ', 14)
+                  << String(measurement.megabytesPerSecond, 1).paddedLeft(' ', 10)
+                  << String(measurement.allocationsPerOperation, 1).paddedLeft(' ', 12)
+                  << String(measurement.allocatedBytesPerOperation, 0).paddedLeft(' ', 12) << std::endl;
+    };
+    
+    std::cout << "stage                         size         ns/op      MB/s   allocs/op    bytes/op" << std::endl;
+    
+    // Inputs are generated from fixed seeds, so every run times the same data
+    SvgParser parser;
+    
+    if (shouldRun("parseNumber"))
+    {
+        for (int count: {16, 256, 4096})
+        {
+            Random random(count);
+            const auto numbers = getNumbers(count, random);
+            
+            add(measure("parseNumber", count, numbers.getNumBytesAsUTF8(), minSeconds, [&] {
+                SvgParserProbe::parseNumbers(parser, numbers);
+            }));
+        }
+    }
+    
+    if (shouldRun("parseSVGPathData"))
+    {
+        for (int count: {16, 256, 4096})
+        {
+            Random random(count);
+            const auto d = SvgCorpusGenerator(getCorpusOptions(0)).createPathData(random, count);
+            
+            add(measure("parseSVGPathData", count, d.getNumBytesAsUTF8(), minSeconds, [&] {
+                ShapeData shape;
+                SvgParserProbe::parseSVGPathData(parser, d, shape);
+            }));
+        }
+    }
+    
+    if (shouldRun("scanDocument") || shouldRun("parse"))
+    {
+        for (int count: {8, 128, 2048})
+        {
+            const auto svg = SvgCorpusGenerator(getCorpusOptions(count)).generate(0);
+            const MemoryBlock data(svg.toRawUTF8(), svg.getNumBytesAsUTF8());
+            
+            if (shouldRun("scanDocument"))
+            {
+                add(measure("scanDocument", count, (int64) data.getSize(), minSeconds, [&] {
+                    SvgParserProbe::scanDocument(parser, data);
+                }));
+            }
+            
+            if (shouldRun("parse"))
+            {
+                add(measure("parse", count, svg.getNumBytesAsUTF8(), minSeconds, [&] {
+                    Path path;
+                    parser.parse(svg, path);
+                }));
+                
+                add(measure("parse (no code)", count, (int64) data.getSize(), minSeconds, [&] {
+                    SvgParser geometryParser;
+                    geometryParser.setCodeGeneration(false);
+                    Path path;
+                    ShapeData shapes;
+                    geometryParser.parse(data.getData(), data.getSize(), path, shapes);
+                }));
+            }
+        }
+    }
+    
+    if (shouldRun("f"))
+    {
+        for (int count: {16, 256, 4096})
+        {
+            Random random(count);
+            std::vector<float> values;
+            for (int i = 0; i < count; ++i)
+                values.push_back((random.nextFloat() - 0.5f) * 1000.0f);
+            
+            add(measure("f", count, 0, minSeconds, [&] {
+                String code;
+                for (auto value: values)
+                    code << SvgParserProbe::f(parser, value);
+            }));
+        }
+    }
+    
+    if (shouldRun("getBinary") || shouldRun("writeDataAsCppLiteral"))
+    {
+        for (int count: {16, 256, 4096})
+        {
+            Random random(count);
+            Path path;
+            ShapeData shape;
+            SvgParserProbe::parseSVGPathData(parser, SvgCorpusGenerator(getCorpusOptions(0)).createPathData(random, count), shape);
+            shape.appendTo(path);
+            
+            MemoryOutputStream stream;
+            path.writePathToStream(stream);
+            const auto data = stream.getMemoryBlock();
+            
+            if (shouldRun("getBinary"))
+                add(measure("getBinary", count, (int64) data.getSize(), minSeconds, [&] { parser.getBinary(path, "icon"); }));
+            
+            if (shouldRun("writeDataAsCppLiteral"))
+            {
+                add(measure("writeDataAsCppLiteral", count, (int64) data.getSize(), minSeconds, [&] {
+                    MemoryOutputStream out;
+                    build_tools::writeDataAsCppLiteral(data, out, false, true);
+                }));
+            }
+        }
+    }
+}
+
+//! @brief prints the heap allocations of a full parse once the thread's arena is warmed up, for a few
+//! corpus sizes, and split by the stage that made them for one of them
+//! The arena and the code buffer keep their memory between conversions, so what is counted here still
+//! goes to the heap every time: the verbs and coords of each ShapeData, strings, the scanned elements
+//! and the results.
+static void printConversionAllocations()
+{
+    const int numConversions = 10;
+    const int stagesSize = 128;
+    std::vector<AllocationStats::Stage> stagesBefore, stagesAfter;
+    
+    std::cout << std::endl << "Allocations per warmed-up conversion, mean of " << numConversions << std::endl;
+    std::cout << "elements     allocs   allocs/element        bytes   peak heap" << std::endl;
+    
+    for (int count: {8, stagesSize, 2048})
+    {
+        const auto svg = SvgCorpusGenerator(getCorpusOptions(count)).generate(0);
+        SvgParser parser;
+        
+        auto convert = [&] {
+            Path path;
+            parser.parse(svg, path);
+        };
+        
+        // The first conversions size the arena and the code buffer, which the others reuse
+        convert();
+        convert();
+        
+        const auto before = AllocationStats::getTotal();
+        if (count == stagesSize)
+            stagesBefore = AllocationStats::getStages();
+        AllocationStats::resetPeak();
+        
+        for (int i = 0; i < numConversions; ++i)
+            convert();
+        
+        const auto total = AllocationStats::getTotal() - before;
+        if (count == stagesSize)
+            stagesAfter = AllocationStats::getStages();
+        
+        const double allocations = (double) total.allocations / numConversions;
+        std::cout << String(count).paddedLeft(' ', 8) << String(allocations, 0).paddedLeft(' ', 11)
+                  << String(allocations / count, 1).paddedLeft(' ', 17)
+                  << String((double) total.bytes / numConversions, 0).paddedLeft(' ', 13)
+                  << File::descriptionOfSizeInBytes(AllocationStats::getPeakHeapBytes()).paddedLeft(' ', 12) << std::endl;
+    }
+    
+    std::cout << std::endl << "By stage, per warmed-up conversion of " << stagesSize << " elements" << std::endl;
+    
+    // Stages seen for the first time during the conversions have nothing to subtract
+    for (size_t i = 0; i < stagesAfter.size(); ++i)
+    {
+        const auto counts = i < stagesBefore.size() ? stagesAfter[i].counts - stagesBefore[i].counts : stagesAfter[i].counts;
+        
+        if (counts.allocations > 0)
+            std::cout << "  " << String(stagesAfter[i].name).paddedRight(' ', 26)
+                      << String((double) counts.allocations / numConversions, 1).paddedLeft(' ', 10) << " allocs"
+                      << String((double) counts.bytes / numConversions, 0).paddedLeft(' ', 12) << " bytes" << std::endl;
+    }
+}
+
+//! @brief writes the results with enough about the build to tell runs apart
+static bool writeJson(const Array<Measurement>& results, const File& file)
+{
+    DynamicObject::Ptr root(new DynamicObject());
+    root->setProperty("juceVersion", SystemStats::getJUCEVersion());
+    root->setProperty("os", SystemStats::getOperatingSystemName());
+    root->setProperty("cpu", SystemStats::getCpuModel());
+#if JUCE_DEBUG
+    root->setProperty("configuration", "Debug");
+#else
+    root->setProperty("configuration", "Release");
+#endif
+    root->setProperty("time", Time::getCurrentTime().toISO8601(true));
+    root->setProperty("allocationStats", AllocationStats::isEnabled);
+    
+    Array<var> entries;
+    for (const auto& result: results)
+    {
+        DynamicObject::Ptr entry(new DynamicObject());
+        entry->setProperty("name", result.name);
+        entry->setProperty("size", result.size);
+        entry->setProperty("bytes", result.bytes);
+        entry->setProperty("iterations", result.iterations);
+        entry->setProperty("nsPerOp", result.nanosecondsPerOperation);
+        entry->setProperty("mbPerSecond", result.megabytesPerSecond);
+        entry->setProperty("allocsPerOp", result.allocationsPerOperation);
+        entry->setProperty("allocatedBytesPerOp", result.allocatedBytesPerOperation);
+        entries.add(var(entry.get()));
+    }
+    
+    root->setProperty("results", entries);
+    return file.replaceWithText(JSON::toString(var(root.get())));
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    ArgumentList args(argc, argv);
+    
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: Svg2PathMicroBenchmarks [--filter <stage>] [--min-time <ms>] [--json <file>]" << std::endl;
+        return 0;
+    }
+    
+    const auto filter = args.containsOption("--filter") ? args.getValueForOption("--filter") : String();
+    const double minSeconds = args.containsOption("--min-time")
+                                ? jmax(1.0, args.getValueForOption("--min-time").getDoubleValue()) / 1000.0
+                                : 0.2;
+    
+    if (!AllocationStats::isEnabled)
+        std::cerr << "Built without SVG2PATH_ALLOCATION_STATS, configure with -DAllocationStats=ON to count allocations" << std::endl;
+    
+    Array<Measurement> results;
+    runBenchmarks(filter, minSeconds, results);
+    
+    if (AllocationStats::isEnabled)
+        printConversionAllocations();
+    
+    if (args.containsOption("--json"))
+    {
+        auto file = args.getFileForOption("--json");
+        
+        if (!writeJson(results, file))
+        {
+            std::cerr << "Could not write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    
+    return 0;
+}
@@ -0,0 +1,319 @@
+/*
+  ==============================================================================
+
+    Sweeps the emitted precision, quantisation and simplification per svg, and
+    reports which settings trade the least accuracy for the most size and speed.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SvgParser.h"
+#include "SvgCorpusGenerator.h"
+#include "GeneratedCode.h"
+#include <iostream>
+
+//==============================================================================
+//! @brief the distance from any point to a path's outline, with the outline's segments bucketed in a grid
+//! A query only looks at the cells around the point, widening the search ring by ring until no
+//! cell further out can hold a closer segment.
+class OutlineDistance
+{
+public:
+    //! @arg path: the outline, flattened into segments
+    //! @arg tolerance: the flattening tolerance, well below the errors being measured
+    OutlineDistance(const Path& path, float tolerance)
+    {
+        for (PathFlatteningIterator it(path, {}, tolerance); it.next();)
+            segments.push_back({{it.x1, it.y1}, {it.x2, it.y2}});
+        
+        if (segments.empty())
+            return;
+        
+        bounds = path.getBounds().expanded(tolerance);
+        numCells = jlimit(1, 256, (int) std::sqrt((double) segments.size()));
+        cellSize = jmax(bounds.getWidth(), bounds.getHeight(), 1.0e-6f) / (float) numCells;
+        cells.resize((size_t) (numCells * numCells));
+        
+        for (size_t i = 0; i < segments.size(); ++i)
+        {
+            const auto& segment = segments[i];
+            const auto first = getCell(Point<float>(jmin(segment.getStartX(), segment.getEndX()),
+                                                    jmin(segment.getStartY(), segment.getEndY())));
+            const auto last = getCell(Point<float>(jmax(segment.getStartX(), segment.getEndX()),
+                                                   jmax(segment.getStartY(), segment.getEndY())));
+            
+            for (int y = first.y; y <= last.y; ++y)
+                for (int x = first.x; x <= last.x; ++x)
+                    cells[(size_t) (y * numCells + x)].push_back(i);
+        }
+    }
+    
+    bool isEmpty() const { return segments.empty(); }
+    
+    //! @brief returns the distance from a point to the nearest segment
+    float getDistance(Point<float> point) const
+    {
+        const auto centre = getCell(point);
+        float best = std::numeric_limits<float>::max();
+        
+        for (int ring = 0; ring <= numCells; ++ring)
+        {
+            for (int y = centre.y - ring; y <= centre.y + ring; ++y)
+            {
+                for (int x = centre.x - ring; x <= centre.x + ring; ++x)
+                {
+                    // Only the cells on the ring's edge are new
+                    if ((std::abs(x - centre.x) != ring && std::abs(y - centre.y) != ring)
+                        || x < 0 || y < 0 || x >= numCells || y >= numCells)
+                        continue;
+                    
+                    for (auto index: cells[(size_t) (y * numCells + x)])
+                    {
+                        Point<float> nearest;
+                        best = jmin(best, segments[index].getDistanceFromPoint(point, nearest));
+                    }
+                }
+            }
+            
+            // Every cell in the next ring is at least this far from the point
+            if (best <= (float) ring * cellSize)
+                break;
+        }
+        
+        return best;
+    }
+    
+    //! @brief returns the largest distance from a point on this outline to the other outline
+    //! @arg spacing: the distance between the points sampled along this outline
+    float getDistanceTo(const OutlineDistance& other, float spacing) const
+    {
+        float maxDistance = 0.0f;
+        
+        for (const auto& segment: segments)
+        {
+            const int numSamples = jmax(1, (int) std::ceil(segment.getLength() / spacing));
+            for (int i = 0; i <= numSamples; ++i)
+                maxDistance = jmax(maxDistance, other.getDistance(segment.getPointAlongLineProportionally((float) i / (float) numSamples)));
+        }
+        
+        return maxDistance;
+    }
+    
+    //! @brief returns the Hausdorff distance between two outlines, the furthest either strays from the other
+    static float getHausdorffDistance(const OutlineDistance& a, const OutlineDistance& b, float spacing)
+    {
+        if (a.isEmpty() || b.isEmpty())
+            return a.isEmpty() == b.isEmpty() ? 0.0f : std::numeric_limits<float>::max();
+        
+        return jmax(a.getDistanceTo(b, spacing), b.getDistanceTo(a, spacing));
+    }
+    
+private:
+    Point<int> getCell(Point<float> point) const
+    {
+        return {jlimit(0, numCells - 1, (int) ((point.x - bounds.getX()) / cellSize)),
+                jlimit(0, numCells - 1, (int) ((point.y - bounds.getY()) / cellSize))};
+    }
+    
+    std::vector<Line<float>> segments;
+    std::vector<std::vector<size_t>> cells;
+    Rectangle<float> bounds;
+    int numCells{0};
+    float cellSize{1.0f};
+};
+
+//==============================================================================
+//! @brief one point of the sweep and what it cost
+struct Setting
+{
+    int precision;
+    float quantisation;
+    float simplification;
+    float error{0.0f};  // the Hausdorff distance to the unmodified parse, in pixels
+    int bytes{0};       // the size of the generated code
+    double fillTime{0.0};
+    
+    bool dominates(const Setting& other) const
+    {
+        return error <= other.error && bytes <= other.bytes && (error < other.error || bytes < other.bytes);
+    }
+    
+    String describe() const
+    {
+        return "precision " + String(precision) + ", quantisation " + String(quantisation, 3)
+               + ", simplification " + String(simplification, 3);
+    }
+};
+
+static const int precisions[] = {0, 1, 2, 3};
+static const float quantisations[] = {0.0f, 0.05f, 0.1f, 0.25f, 0.5f};
+static const float simplifications[] = {0.0f, 0.05f, 0.1f, 0.25f, 0.5f};
+
+//! @brief returns the median time of filling a path into a software image
+static double getFillTime(const Path& path, int size)
+{
+    Image image(Image::ARGB, size, size, true, SoftwareImageType());
+    Graphics g(image);
+    g.setColour(Colours::black);
+    g.fillPath(path);
+    
+    const int numSamples = 15, batch = 20;
+    std::vector<double> samples;
+    
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        auto start = Time::getHighResolutionTicks();
+        for (int i = 0; i < batch; ++i)
+            g.fillPath(path);
+        
+        samples.push_back(Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1.0e9 / batch);
+    }
+    
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+//! @brief sweeps every setting on one svg, and prints the settings no other beats on both error and size
+//! @return the recommended setting, the smallest within the error budget
+static Setting reportAsset(const String& name, const String& svg, int size, float budget)
+{
+    auto configure = [size](SvgParser& parser) {
+        parser.setNormalisation(SvgParser::Normalisation::fit, (float) size, (float) size);
+    };
+    
+    // The reference is the geometry before it is rounded for output
+    SvgParser referenceParser;
+    configure(referenceParser);
+    Path reference;
+    referenceParser.parse(svg, reference);
+    
+    const float tolerance = 0.01f;
+    const OutlineDistance referenceOutline(reference, tolerance);
+    std::vector<Setting> settings;
+    
+    for (auto precision: precisions)
+    {
+        for (auto quantisation: quantisations)
+        {
+            for (auto simplification: simplifications)
+            {
+                SvgParser parser;
+                configure(parser);
+                parser.setPrecision(precision);
+                parser.setQuantisation(quantisation);
+                parser.setSimplification(simplification);
+                
+                Path path;
+                const auto code = parser.parse(svg, path);
+                
+                // Measure what the generated code draws, with its rounding
+                Path emitted;
+                GeneratedCode(code).replay(emitted);
+                
+                Setting setting{precision, quantisation, simplification};
+                setting.error = OutlineDistance::getHausdorffDistance(referenceOutline, OutlineDistance(emitted, tolerance), tolerance * 4.0f);
+                setting.bytes = (int) code.getNumBytesAsUTF8();
+                setting.fillTime = getFillTime(emitted, size);
+                settings.push_back(setting);
+            }
+        }
+    }
+    
+    std::vector<Setting> frontier;
+    for (const auto& setting: settings)
+        if (std::none_of(settings.begin(), settings.end(), [&](const Setting& other) { return other.dominates(setting); }))
+            frontier.push_back(setting);
+    
+    std::sort(frontier.begin(), frontier.end(), [](const Setting& a, const Setting& b) { return a.bytes < b.bytes; });
+    
+    // The cheapest setting within the budget, the most accurate one if none is
+    Setting recommended = *std::min_element(settings.begin(), settings.end(), [budget](const Setting& a, const Setting& b) {
+        const bool aFits = a.error <= budget, bFits = b.error <= budget;
+        if (aFits != bFits)
+            return aFits;
+        if (!aFits)
+            return a.error < b.error;
+        return a.bytes != b.bytes ? a.bytes < b.bytes : a.fillTime < b.fillTime;
+    });
+    
+    std::cout << name << std::endl;
+    std::cout << "  decimals  quantise  simplify   error px     bytes   fill ns" << std::endl;
+    
+    for (const auto& setting: frontier)
+    {
+        const bool isRecommended = setting.precision == recommended.precision && setting.quantisation == recommended.quantisation
+                                && setting.simplification == recommended.simplification;
+        
+        std::cout << (isRecommended ? "* " : "  ") << String(setting.precision).paddedLeft(' ', 8)
+                  << String(setting.quantisation, 3).paddedLeft(' ', 10) << String(setting.simplification, 3).paddedLeft(' ', 10)
+                  << String(setting.error, 4).paddedLeft(' ', 11) << String(setting.bytes).paddedLeft(' ', 10)
+                  << String(setting.fillTime, 0).paddedLeft(' ', 10) << std::endl;
+    }
+    
+    std::cout << "  recommended: " << recommended.describe() << std::endl << std::endl;
+    return recommended;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    ArgumentList args(argc, argv);
+    
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: Svg2PathParetoReport [svg files or folders]... [--size <px>] [--budget <px>] [--corpus <n>]" << std::endl
+                  << "Coordinates are normalised to the size, and errors are measured in pixels at it." << std::endl;
+        return 0;
+    }
+    
+    const int size = args.containsOption("--size") ? jmax(1, args.getValueForOption("--size").getIntValue()) : 24;
+    const float budget = args.containsOption("--budget") ? args.getValueForOption("--budget").getFloatValue() : 0.25f;
+    const int corpusSize = args.containsOption("--corpus") ? jmax(1, args.getValueForOption("--corpus").getIntValue()) : 5;
+    
+    std::vector<std::pair<String, String>> svgs;
+    for (int i = 0; i < args.size(); ++i)
+    {
+        if (args[i].isOption())
+        {
+            ++i;
+            continue;
+        }
+        
+        auto file = args[i].resolveAsFile();
+        
+        if (file.isDirectory())
+            for (const auto& child: file.findChildFiles(File::findFiles, true, "*.svg"))
+                svgs.emplace_back(child.getFileName(), child.loadFileAsString());
+        else if (file.existsAsFile())
+            svgs.emplace_back(file.getFileName(), file.loadFileAsString());
+    }
+    
+    if (svgs.empty())
+    {
+        SvgCorpusGenerator::Options options;
+        options.numElements = 8;
+        options.viewBoxSize = 24.0f;
+        SvgCorpusGenerator generator(options);
+        
+        for (int i = 0; i < corpusSize; ++i)
+            svgs.emplace_back("corpus_" + String(i), generator.generate(i));
+    }
+    
+    std::cout << "Error budget " << budget << "px at " << size << "px, * marks the recommended setting" << std::endl << std::endl;
+    
+    int64 defaultBytes = 0, recommendedBytes = 0;
+    for (const auto& svg: svgs)
+    {
+        SvgParser parser;
+        parser.setNormalisation(SvgParser::Normalisation::fit, (float) size, (float) size);
+        Path path;
+        defaultBytes += parser.parse(svg.second, path).getNumBytesAsUTF8();
+        recommendedBytes += reportAsset(svg.first, svg.second, size, budget).bytes;
+    }
+    
+    std::cout << "Generated code for " << svgs.size() << " svgs: " << defaultBytes << " bytes at the defaults, "
+              << recommendedBytes << " at the recommended settings" << std::endl;
+    
+    return 0;
+}
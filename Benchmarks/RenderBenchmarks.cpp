@@ -0,0 +1,293 @@
+/*
+  ==============================================================================
+
+    Measures what the converter's output costs to rebuild and to draw, per asset,
+    to decide from numbers whether an icon is worth simplifying or flattening.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SvgParser.h"
+#include "SvgCorpusGenerator.h"
+#include "GeneratedCode.h"
+#include <iostream>
+
+//==============================================================================
+//! @brief the spread of one measurement over its samples
+//! A sample is the mean time of a batch of calls, so with more than one call per sample these
+//! are percentiles of batch means, which hide how slow a single call can be.
+struct Percentiles
+{
+    double p50{0.0};
+    double p90{0.0};
+    double p99{0.0};
+    int callsPerSample{1};
+};
+
+//! @brief times a function in samples and returns the percentiles of the time per call
+//! Each sample runs enough calls to take a few microseconds, so the clock's resolution doesn't
+//! show in the results. Calls that take that long on their own are timed singly, so the tail
+//! percentiles of large fills catch calls that hit a slow path, not just noise.
+template <typename Function>
+static Percentiles getNanosecondsPerCall(int numSamples, Function&& function)
+{
+    function();
+    
+    int batch = 1;
+    while (batch < (1 << 20))
+    {
+        auto start = Time::getHighResolutionTicks();
+        for (int i = 0; i < batch; ++i)
+            function();
+        
+        if (Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) >= 20.0e-6)
+            break;
+        
+        batch *= 2;
+    }
+    
+    std::vector<double> samples((size_t) numSamples);
+    for (auto& sample: samples)
+    {
+        auto start = Time::getHighResolutionTicks();
+        for (int i = 0; i < batch; ++i)
+            function();
+        
+        sample = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1.0e9 / batch;
+    }
+    
+    std::sort(samples.begin(), samples.end());
+    auto getPercentile = [&](double p) { return samples[(size_t) std::round(p * (double) (samples.size() - 1))]; };
+    
+    return {getPercentile(0.5), getPercentile(0.9), getPercentile(0.99), batch};
+}
+
+//==============================================================================
+//! @brief one converted svg and what it costs
+struct Asset
+{
+    String name;
+    Path path;
+    MemoryBlock pathData; // what getBinary embeds
+    size_t numCalls{0};
+    Percentiles load, replay;
+    std::vector<Percentiles> fills; // for each size and transform in turn
+};
+
+//! @brief a transform the icon is drawn with, on top of fitting it into the image
+struct DrawTransform
+{
+    const char* name;
+    AffineTransform transform; // about the image's centre, in units of the image size
+};
+
+static const int renderSizes[] = {16, 32, 64, 256};
+
+static const DrawTransform drawTransforms[] = {
+    {"fit", {}},
+    {"rotate", AffineTransform::rotation(MathConstants<float>::pi / 6.0f)},
+    {"skew", AffineTransform::shear(0.3f, 0.0f).scaled(0.8f, 1.0f)},
+};
+
+//! @brief converts the svgs named on the command line, or a generated corpus when none are given
+static std::vector<Asset> getAssets(const ArgumentList& args, int corpusSize)
+{
+    std::vector<std::pair<String, String>> svgs;
+    
+    for (int i = 0; i < args.size(); ++i)
+    {
+        if (args[i].isOption())
+        {
+            // Every option this harness takes has a value
+            ++i;
+            continue;
+        }
+        
+        auto file = args[i].resolveAsFile();
+        
+        if (file.isDirectory())
+            for (const auto& child: file.findChildFiles(File::findFiles, true, "*.svg"))
+                svgs.emplace_back(child.getFileName(), child.loadFileAsString());
+        else if (file.existsAsFile())
+            svgs.emplace_back(file.getFileName(), file.loadFileAsString());
+    }
+    
+    if (svgs.empty())
+    {
+        SvgCorpusGenerator::Options options;
+        options.numElements = 12;
+        options.viewBoxSize = 24.0f;
+        options.arcProbability = 0.2f;
+        SvgCorpusGenerator generator(options);
+        
+        for (int i = 0; i < corpusSize; ++i)
+            svgs.emplace_back("corpus_" + String(i), generator.generate(i));
+    }
+    
+    std::vector<Asset> assets;
+    
+    for (const auto& svg: svgs)
+    {
+        SvgParser parser;
+        Asset asset;
+        asset.name = svg.first;
+        
+        auto code = parser.parse(svg.second, asset.path);
+        
+        if (asset.path.isEmpty())
+        {
+            std::cerr << svg.first << ": " << code << std::endl;
+            continue;
+        }
+        
+        MemoryOutputStream stream;
+        asset.path.writePathToStream(stream);
+        asset.pathData = stream.getMemoryBlock();
+        
+        // The fill is timed on the path the generated code builds, rounding included
+        GeneratedCode generated(code);
+        asset.numCalls = generated.getNumCalls();
+        
+        asset.load = getNanosecondsPerCall(51, [&] {
+            Path path;
+            path.loadPathFromData(asset.pathData.getData(), asset.pathData.getSize());
+        });
+        asset.replay = getNanosecondsPerCall(51, [&] {
+            Path path;
+            generated.replay(path);
+        });
+        
+        asset.path.clear();
+        generated.replay(asset.path);
+        assets.push_back(std::move(asset));
+    }
+    
+    return assets;
+}
+
+//! @brief times filling every asset into a software image at each size and transform
+static void measureFills(std::vector<Asset>& assets, int numSamples)
+{
+    for (auto size: renderSizes)
+    {
+        Image image(Image::ARGB, size, size, true, SoftwareImageType());
+        Graphics g(image);
+        g.setColour(Colours::black);
+        const auto area = image.getBounds().toFloat();
+        
+        for (const auto& drawTransform: drawTransforms)
+        {
+            const auto aroundCentre = AffineTransform::translation(-area.getCentreX(), -area.getCentreY())
+                                          .followedBy(drawTransform.transform)
+                                          .translated(area.getCentreX(), area.getCentreY());
+            
+            for (auto& asset: assets)
+            {
+                const auto transform = RectanglePlacement(RectanglePlacement::centred)
+                                           .getTransformToFit(asset.path.getBounds(), area)
+                                           .followedBy(aroundCentre);
+                
+                asset.fills.push_back(getNanosecondsPerCall(numSamples, [&] { g.fillPath(asset.path, transform); }));
+            }
+        }
+    }
+}
+
+//==============================================================================
+static void printReport(const std::vector<Asset>& assets)
+{
+    std::cout << "Rebuilding the path, ns p50 / p99" << std::endl;
+    std::cout << "asset                        calls   bytes    loadPathFromData     createPath()" << std::endl;
+    
+    for (const auto& asset: assets)
+    {
+        std::cout << asset.name.substring(0, 26).paddedRight(' ', 27)
+                  << String((int) asset.numCalls).paddedLeft(' ', 7)
+                  << String((int) asset.pathData.getSize()).paddedLeft(' ', 8)
+                  << (String(asset.load.p50, 0) + " / " + String(asset.load.p99, 0)).paddedLeft(' ', 20)
+                  << (String(asset.replay.p50, 0) + " / " + String(asset.replay.p99, 0)).paddedLeft(' ', 17) << std::endl;
+    }
+    
+    std::cout << std::endl << "Filling into a software image, ns p50 / p90 / p99 of samples, and calls per sample" << std::endl;
+    std::cout << "A sample of more than one call is its batch's mean, so its percentiles understate single slow calls" << std::endl;
+    
+    size_t column = 0;
+    for (auto size: renderSizes)
+    {
+        for (const auto& drawTransform: drawTransforms)
+        {
+            std::cout << size << "px " << drawTransform.name << std::endl;
+            
+            for (const auto& asset: assets)
+            {
+                const auto& fill = asset.fills[column];
+                std::cout << "  " << asset.name.substring(0, 26).paddedRight(' ', 27)
+                          << String(fill.p50, 0).paddedLeft(' ', 10) << String(fill.p90, 0).paddedLeft(' ', 10)
+                          << String(fill.p99, 0).paddedLeft(' ', 10) << String(fill.callsPerSample).paddedLeft(' ', 8)
+                          << std::endl;
+            }
+            
+            ++column;
+        }
+    }
+    
+    // Rank on each asset's p50 relative to the median asset's in the same configuration, averaged
+    // over every size and transform. Summing nanoseconds would rank on the 256px fills alone, as
+    // they take many times longer than the small ones.
+    if (assets.empty())
+        return;
+    
+    std::vector<double> typical(column, 0.0);
+    for (size_t i = 0; i < column; ++i)
+    {
+        std::vector<double> medians;
+        for (const auto& asset: assets)
+            medians.push_back(asset.fills[i].p50);
+        
+        std::nth_element(medians.begin(), medians.begin() + (std::ptrdiff_t) (medians.size() / 2), medians.end());
+        typical[i] = jmax(1.0, medians[medians.size() / 2]);
+    }
+    
+    std::vector<std::pair<double, String>> ranking;
+    for (const auto& asset: assets)
+    {
+        double total = 0.0;
+        for (size_t i = 0; i < column; ++i)
+            total += asset.fills[i].p50 / typical[i];
+        
+        ranking.emplace_back(total / (double) column, asset.name);
+    }
+    
+    std::sort(ranking.begin(), ranking.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    
+    std::cout << std::endl << "Most expensive to draw, mean p50 over all sizes and transforms relative to the median asset"
+              << std::endl;
+    for (size_t i = 0; i < jmin((size_t) 10, ranking.size()); ++i)
+        std::cout << "  " << ranking[i].second.paddedRight(' ', 27) << String(ranking[i].first, 2).paddedLeft(' ', 10)
+                  << "x" << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    ArgumentList args(argc, argv);
+    
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: Svg2PathRenderBenchmarks [svg files or folders]... [--samples <n>] [--corpus <n>]" << std::endl
+                  << "Without svgs, a generated corpus of --corpus files is measured." << std::endl;
+        return 0;
+    }
+    
+    const int numSamples = args.containsOption("--samples") ? jmax(3, args.getValueForOption("--samples").getIntValue()) : 101;
+    const int corpusSize = args.containsOption("--corpus") ? jmax(1, args.getValueForOption("--corpus").getIntValue()) : 10;
+    
+    auto assets = getAssets(args, corpusSize);
+    std::cout << "Measuring " << assets.size() << " assets, " << numSamples << " samples each" << std::endl << std::endl;
+    
+    measureFills(assets, numSamples);
+    printReport(assets);
+    
+    return 0;
+}
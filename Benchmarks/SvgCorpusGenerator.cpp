@@ -0,0 +1,263 @@
+#include "SvgCorpusGenerator.h"
+
+//==============================================================================
+struct SvgCorpusGenerator::PathDataWriter
+{
+    PathDataWriter(const SvgCorpusGenerator& generator, Random& random) : generator(generator), random(random) {}
+    
+    void addCommand(juce_wchar command)
+    {
+        data << String::charToString(command);
+        previousNumber = {};
+        previousWasFlag = false;
+    }
+    
+    //! @brief adds a number rounded the way it is written, and returns the value a parser reads back
+    float addNumber(float value)
+    {
+        const int decimals = random.nextInt(generator.options.maxDecimals + 1);
+        const auto number = generator.formatNumber(value, decimals, random);
+        
+        // A separator can go when the next number can't be read as part of the last one
+        const bool compact = random.nextFloat() < generator.options.compactProbability;
+        const bool canJoin = previousNumber.isEmpty() || previousWasFlag
+                          || number.startsWithChar('-')
+                          || (number.startsWithChar('.') && previousNumber.containsChar('.')
+                              && !previousNumber.containsAnyOf("eE"));
+        
+        if (previousNumber.isNotEmpty() && !(compact && canJoin))
+            data << (random.nextBool() ? " " : ",");
+        
+        data << number;
+        previousNumber = number;
+        previousWasFlag = false;
+        return number.getFloatValue();
+    }
+    
+    void addFlag(bool flag)
+    {
+        // Flags are single digits, so they can be packed against each other but not against the rotation
+        if (previousNumber.isNotEmpty() && !(previousWasFlag && random.nextFloat() < generator.options.compactProbability))
+            data << " ";
+        
+        data << (flag ? "1" : "0");
+        previousNumber = flag ? "1" : "0";
+        previousWasFlag = true;
+    }
+    
+    const SvgCorpusGenerator& generator;
+    Random& random;
+    String data;
+    String previousNumber; // the last number written since the last command letter
+    bool previousWasFlag{false};
+};
+
+//==============================================================================
+Random SvgCorpusGenerator::getRandom(int index) const
+{
+    // Spread neighbouring indices apart, so file n + 1 isn't file n shifted by one draw
+    return Random((int64) ((uint64) options.seed * 6364136223846793005ULL + (uint64) index * 1442695040888963407ULL));
+}
+
+String SvgCorpusGenerator::formatNumber(float value, int decimals, Random& random) const
+{
+    String number;
+    
+    if (random.nextFloat() < options.exponentProbability)
+        number = String::formatted("%.*e", jmax(0, decimals), value);
+    else
+        number = String::formatted("%.*f", jmax(0, decimals), value);
+    
+    if (random.nextFloat() < options.compactProbability)
+    {
+        if (number.startsWith("0."))
+            number = number.substring(1);
+        else if (number.startsWith("-0."))
+            number = "-" + number.substring(2);
+    }
+    
+    return number;
+}
+
+String SvgCorpusGenerator::createPathData(Random& random, int numCommands) const
+{
+    PathDataWriter writer(*this, random);
+    const float size = options.viewBoxSize;
+    Point<float> current, subPathStart;
+    
+    auto getPoint = [&] { return Point<float>(random.nextFloat() * size, random.nextFloat() * size); };
+    
+    // Each coordinate is written absolute or relative to the current point, and the current point
+    // follows what was written, rounding included
+    auto addPoint = [&](Point<float> point, bool relative, Point<float> origin) {
+        const auto offset = relative ? origin : Point<float>();
+        const float x = writer.addNumber(point.x - offset.x) + offset.x;
+        const float y = writer.addNumber(point.y - offset.y) + offset.y;
+        return Point<float>(x, y);
+    };
+    
+    writer.addCommand('M');
+    current = subPathStart = addPoint(getPoint(), false, {});
+    
+    for (int i = 0; i < numCommands; ++i)
+    {
+        const bool relative = random.nextFloat() < options.relativeProbability;
+        const int repeats = random.nextFloat() < options.implicitRepeatProbability ? 1 + random.nextInt(3) : 0;
+        auto letter = [relative](char upper) { return (juce_wchar) (relative ? upper - 'A' + 'a' : upper); };
+        
+        if (random.nextFloat() < options.arcProbability)
+        {
+            writer.addCommand(letter('A'));
+            for (int r = 0; r <= repeats; ++r)
+            {
+                writer.addNumber(1.0f + random.nextFloat() * size * 0.25f);
+                writer.addNumber(1.0f + random.nextFloat() * size * 0.25f);
+                writer.addNumber(random.nextFloat() * 360.0f);
+                writer.addFlag(random.nextBool());
+                writer.addFlag(random.nextBool());
+                current = addPoint(getPoint(), relative, current);
+            }
+            
+            continue;
+        }
+        
+        const bool smooth = random.nextFloat() < options.smoothProbability;
+        
+        switch (random.nextInt(6))
+        {
+            case 0:
+                writer.addCommand(letter('L'));
+                for (int r = 0; r <= repeats; ++r)
+                    current = addPoint(getPoint(), relative, current);
+                break;
+            case 1:
+                writer.addCommand(letter('H'));
+                for (int r = 0; r <= repeats; ++r)
+                    current.x = writer.addNumber(getPoint().x - (relative ? current.x : 0.0f)) + (relative ? current.x : 0.0f);
+                break;
+            case 2:
+                writer.addCommand(letter('V'));
+                for (int r = 0; r <= repeats; ++r)
+                    current.y = writer.addNumber(getPoint().y - (relative ? current.y : 0.0f)) + (relative ? current.y : 0.0f);
+                break;
+            case 3:
+                writer.addCommand(letter(smooth ? 'S' : 'C'));
+                for (int r = 0; r <= repeats; ++r)
+                {
+                    if (!smooth)
+                        addPoint(getPoint(), relative, current);
+                    addPoint(getPoint(), relative, current);
+                    current = addPoint(getPoint(), relative, current);
+                }
+                break;
+            case 4:
+                writer.addCommand(letter(smooth ? 'T' : 'Q'));
+                for (int r = 0; r <= repeats; ++r)
+                {
+                    if (!smooth)
+                        addPoint(getPoint(), relative, current);
+                    current = addPoint(getPoint(), relative, current);
+                }
+                break;
+            default:
+                // Close and start a new sub-path, where repeats after M are implicit line tos
+                writer.addCommand(letter('Z'));
+                current = subPathStart;
+                writer.addCommand(letter('M'));
+                current = subPathStart = addPoint(getPoint(), relative, current);
+                for (int r = 0; r < repeats; ++r)
+                    current = addPoint(getPoint(), relative, current);
+                break;
+        }
+    }
+    
+    return writer.data;
+}
+
+void SvgCorpusGenerator::writeElement(Random& random, OutputStream& out) const
+{
+    const float size = options.viewBoxSize;
+    auto number = [&](float scale) { return formatNumber(random.nextFloat() * scale, options.maxDecimals, random); };
+    
+    if (random.nextFloat() < options.pathProbability)
+    {
+        const int numCommands = options.minCommands + random.nextInt(jmax(1, options.maxCommands - options.minCommands + 1));
+        out << "<path d=\"" << createPathData(random, numCommands) << "\"/>\n";
+        return;
+    }
+    
+    switch (random.nextInt(5))
+    {
+        case 0:
+            out << "<rect x=\"" << number(size) << "\" y=\"" << number(size) << "\" width=\"" << number(size * 0.5f)
+                << "\" height=\"" << number(size * 0.5f) << "\" rx=\"" << number(size * 0.05f) << "\"/>\n";
+            break;
+        case 1:
+            out << "<circle cx=\"" << number(size) << "\" cy=\"" << number(size) << "\" r=\"" << number(size * 0.25f) << "\"/>\n";
+            break;
+        case 2:
+            out << "<ellipse cx=\"" << number(size) << "\" cy=\"" << number(size) << "\" rx=\"" << number(size * 0.25f)
+                << "\" ry=\"" << number(size * 0.25f) << "\"/>\n";
+            break;
+        case 3:
+            out << "<line x1=\"" << number(size) << "\" y1=\"" << number(size) << "\" x2=\"" << number(size)
+                << "\" y2=\"" << number(size) << "\" stroke=\"#000\"/>\n";
+            break;
+        default:
+        {
+            out << (random.nextBool() ? "<polygon points=\"" : "<polyline points=\"");
+            for (int i = 0, numPoints = 3 + random.nextInt(8); i < numPoints; ++i)
+                out << (i > 0 ? " " : "") << number(size) << "," << number(size);
+            out << "\"/>\n";
+            break;
+        }
+    }
+}
+
+void SvgCorpusGenerator::write(int index, OutputStream& out) const
+{
+    auto random = getRandom(index);
+    const float size = options.viewBoxSize;
+    const auto start = out.getPosition();
+    
+    out << "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 " << size << " " << size << "\">\n";
+    
+    int depth = 0;
+    auto openGroup = [&] {
+        out << "<g transform=\"translate(" << formatNumber(random.nextFloat() * 4.0f - 2.0f, 2, random) << " "
+            << formatNumber(random.nextFloat() * 4.0f - 2.0f, 2, random) << ")\">\n";
+        ++depth;
+    };
+    
+    // Opening and closing groups at random would hardly ever get far from the root, so the first
+    // element is drawn at the deepest level and every file nests as deep as asked. The groups then
+    // open and close at random, within that depth.
+    while (depth < options.maxDepth)
+        openGroup();
+    
+    for (int i = 0; options.targetBytes > 0 ? out.getPosition() - start < options.targetBytes : i < options.numElements; ++i)
+    {
+        if (i > 0 && depth < options.maxDepth && random.nextFloat() < options.groupProbability)
+            openGroup();
+        
+        writeElement(random, out);
+        
+        if (depth > 0 && random.nextFloat() < options.closeProbability)
+        {
+            out << "</g>\n";
+            --depth;
+        }
+    }
+    
+    for (; depth > 0; --depth)
+        out << "</g>\n";
+    
+    out << "</svg>\n";
+}
+
+String SvgCorpusGenerator::generate(int index) const
+{
+    MemoryOutputStream out;
+    write(index, out);
+    return out.toUTF8();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//! @brief generates synthetic svgs from a seed, for benchmarking and stress testing the parser at any size
+//! The same options, seed and index always give the same bytes, so a corpus never has to be shipped,
+//! only the settings that made it. Every file is valid svg, with each feature of the path grammar mixed
+//! in at the rate the options ask for.
+class SvgCorpusGenerator
+{
+public:
+    struct Options
+    {
+        int64 seed{1};
+        int numElements{100};                 // drawn elements per file
+        int64 targetBytes{0};                 // when above 0, elements are added until the file reaches this size instead
+        int maxDepth{4};                      // the deepest nesting of groups, which the first element is drawn at
+        float groupProbability{0.2f};         // the chance of opening a group before an element
+        float closeProbability{0.2f};         // the chance of closing a group after an element
+        float pathProbability{0.7f};          // the share of elements that are paths, the rest are primitives
+        int minCommands{4};                   // the range of commands in each path's d
+        int maxCommands{32};
+        float relativeProbability{0.5f};      // the share of commands written in lower case
+        float implicitRepeatProbability{0.3f}; // the chance a command is repeated without its letter
+        float smoothProbability{0.15f};       // the share of curves written as S and T
+        float arcProbability{0.1f};           // the share of commands that are arcs
+        int maxDecimals{3};                   // numbers get between 0 and this many decimals
+        float exponentProbability{0.0f};      // the share of numbers written with an exponent
+        float compactProbability{0.0f};       // the chance of leaving out a separator or leading zero where the grammar allows
+        float viewBoxSize{100.0f};
+    };
+    
+    explicit SvgCorpusGenerator(const Options& options) : options(options) {}
+    
+    //! @brief writes one file of the corpus
+    //! @arg index: the file's position in the corpus, which is mixed into the seed
+    //! @arg out: the stream to write to, files larger than memory can go straight to disk
+    void write(int index, OutputStream& out) const;
+    //! @brief returns one file of the corpus
+    String generate(int index) const;
+    //! @brief returns the d attribute of a path with a number of commands, drawn from a generator
+    String createPathData(Random& random, int numCommands) const;
+    
+    const Options& getOptions() const { return options; }
+    
+private:
+    //! @brief builds a d attribute, leaving out separators where the options and the grammar allow
+    struct PathDataWriter;
+    
+    void writeElement(Random& random, OutputStream& out) const;
+    String formatNumber(float value, int decimals, Random& random) const;
+    Random getRandom(int index) const;
+    
+    Options options;
+    
+    JUCE_LEAK_DETECTOR(SvgCorpusGenerator)
+};
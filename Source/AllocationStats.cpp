@@ -0,0 +1,168 @@
+#include "AllocationStats.h"
+#include <atomic>
+#include <cstring>
+#include <new>
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+ #include <psapi.h>
+ #pragma comment(lib, "psapi.lib")
+#else
+ #include <sys/resource.h>
+#endif
+
+//==============================================================================
+// Stage 0 collects allocations made outside any stage. Stages are only ever added, so readers
+// never need the lock
+static constexpr int maxStages = 64;
+static std::atomic<const char*> stageNames[maxStages];
+static std::atomic<int> numStages{1};
+static SpinLock stagesLock;
+
+static std::atomic<int64> stageAllocations[maxStages];
+static std::atomic<int64> stageBytes[maxStages];
+static std::atomic<int64> heapBytes{0};
+static std::atomic<int64> peakHeapBytes{0};
+
+static thread_local int currentStage = 0;
+
+static int getStageIndex(const char* name)
+{
+    auto find = [name] {
+        for (int i = 1; i < numStages.load(); ++i)
+        {
+            const char* stageName = stageNames[i].load();
+            if (stageName == name || std::strcmp(stageName, name) == 0)
+                return i;
+        }
+        
+        return -1;
+    };
+    
+    auto index = find();
+    if (index >= 0)
+        return index;
+    
+    const SpinLock::ScopedLockType lock(stagesLock);
+    
+    index = find();
+    if (index >= 0)
+        return index;
+    
+    // Past the limit, further stages count as other
+    if (numStages.load() == maxStages)
+        return 0;
+    
+    index = numStages.load();
+    stageNames[index] = name;
+    numStages = index + 1;
+    return index;
+}
+
+AllocationStats::ScopedStage::ScopedStage(const char* name) : previousStage(currentStage)
+{
+    currentStage = getStageIndex(name);
+}
+
+AllocationStats::ScopedStage::~ScopedStage()
+{
+    currentStage = previousStage;
+}
+
+//==============================================================================
+AllocationStats::Counts AllocationStats::getTotal()
+{
+    Counts total;
+    for (int i = 0; i < numStages.load(); ++i)
+    {
+        total.allocations += stageAllocations[i].load();
+        total.bytes += stageBytes[i].load();
+    }
+    
+    return total;
+}
+
+std::vector<AllocationStats::Stage> AllocationStats::getStages()
+{
+    std::vector<Stage> stages;
+    for (int i = 0; i < numStages.load(); ++i)
+        stages.push_back({i == 0 ? "other" : stageNames[i].load(), {stageAllocations[i].load(), stageBytes[i].load()}});
+    
+    return stages;
+}
+
+void AllocationStats::resetPeak()
+{
+    peakHeapBytes = heapBytes.load();
+}
+
+int64 AllocationStats::getPeakHeapBytes()
+{
+    return peakHeapBytes.load();
+}
+
+int64 AllocationStats::getPeakResidentBytes()
+{
+#if JUCE_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return (int64) counters.PeakWorkingSetSize;
+    
+    return 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    
+    // Linux reports kilobytes, macOS bytes
+   #if JUCE_MAC || JUCE_IOS
+    return (int64) usage.ru_maxrss;
+   #else
+    return (int64) usage.ru_maxrss * 1024;
+   #endif
+#endif
+}
+
+//==============================================================================
+#if SVG2PATH_ALLOCATION_STATS
+
+// Each block is preceded by its size, padded to keep malloc's alignment, so delete knows what it frees
+static constexpr size_t blockHeaderSize = 16;
+
+static void* allocate(size_t size)
+{
+    auto* block = static_cast<char*>(std::malloc(size + blockHeaderSize));
+    
+    if (block == nullptr)
+        throw std::bad_alloc();
+    
+    *reinterpret_cast<size_t*>(block) = size;
+    
+    ++stageAllocations[currentStage];
+    stageBytes[currentStage] += (int64) size;
+    
+    const auto inUse = heapBytes += (int64) size;
+    auto peak = peakHeapBytes.load();
+    while (inUse > peak && !peakHeapBytes.compare_exchange_weak(peak, inUse)) {}
+    
+    return block + blockHeaderSize;
+}
+
+static void deallocate(void* memory) noexcept
+{
+    if (memory == nullptr)
+        return;
+    
+    auto* block = static_cast<char*>(memory) - blockHeaderSize;
+    heapBytes -= (int64) *reinterpret_cast<size_t*>(block);
+    std::free(block);
+}
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void operator delete(void* memory) noexcept { deallocate(memory); }
+void operator delete[](void* memory) noexcept { deallocate(memory); }
+void operator delete(void* memory, size_t) noexcept { deallocate(memory); }
+void operator delete[](void* memory, size_t) noexcept { deallocate(memory); }
+
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreIncludes.h"
+
+#ifndef SVG2PATH_ALLOCATION_STATS
+ #define SVG2PATH_ALLOCATION_STATS 0
+#endif
+
+//! @brief counts heap allocations per stage of a conversion, when built with SVG2PATH_ALLOCATION_STATS
+//! The build replaces the global operator new and delete with versions that count every call and
+//! the bytes asked for, attributed to the innermost stage open on the calling thread. Stages are
+//! the spans SVG2PATH_TRACE_SCOPE marks. Without the flag nothing is replaced, and every count
+//! reads as zero.
+class AllocationStats
+{
+public:
+    static constexpr bool isEnabled = SVG2PATH_ALLOCATION_STATS != 0;
+    
+    struct Counts
+    {
+        int64 allocations{0};
+        int64 bytes{0};
+        
+        Counts operator-(const Counts& other) const { return {allocations - other.allocations, bytes - other.bytes}; }
+    };
+    
+    struct Stage
+    {
+        const char* name;
+        Counts counts;
+    };
+    
+    //! @brief returns the allocations made since the process started, on all threads
+    static Counts getTotal();
+    //! @brief returns the allocations made in each stage since the process started, allocations
+    //! outside any stage are counted under "other"
+    static std::vector<Stage> getStages();
+    //! @brief starts measuring the peak of heap memory in use afresh from what is in use now
+    static void resetPeak();
+    //! @brief returns the most heap memory in use at once since the last resetPeak
+    static int64 getPeakHeapBytes();
+    //! @brief returns the most memory the process has had resident at once, as the OS reports it
+    static int64 getPeakResidentBytes();
+    
+    //! @brief attributes the calling thread's allocations to a stage until it goes out of scope
+    class ScopedStage
+    {
+    public:
+        //! @arg name: a string literal, only the pointer is kept
+        explicit ScopedStage(const char* name);
+        ~ScopedStage();
+        
+    private:
+        int previousStage;
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedStage)
+    };
+};
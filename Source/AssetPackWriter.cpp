@@ -0,0 +1,109 @@
+#include "AssetPackWriter.h"
+#include "Runtime/NameHash.h"
+
+static uint64 alignUp(uint64 offset)
+{
+    return (offset + AssetPack::alignment - 1) & ~(uint64) (AssetPack::alignment - 1);
+}
+
+static void put32(uint8* dest, uint32 value)
+{
+    value = ByteOrder::swapIfBigEndian(value);
+    std::memcpy(dest, &value, sizeof(value));
+}
+
+static void put64(uint8* dest, uint64 value)
+{
+    value = ByteOrder::swapIfBigEndian(value);
+    std::memcpy(dest, &value, sizeof(value));
+}
+
+void AssetPackWriter::addAsset(const String& name, const ShapeData& shape)
+{
+    const uint32 hash = NameHash::compute(name.toRawUTF8(), name.getNumBytesAsUTF8());
+    Asset asset{name, hash, shape.verbs, shape.coords};
+    
+    // The reader binary searches the index by hash, ties are ordered by name to keep builds stable
+    auto it = std::lower_bound(assets.begin(), assets.end(), asset, [](const Asset& a, const Asset& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.name < b.name;
+    });
+    
+    if (it != assets.end() && it->name == name)
+        *it = std::move(asset);
+    else
+        assets.insert(it, std::move(asset));
+}
+
+MemoryBlock AssetPackWriter::build() const
+{
+    const auto numEntries = (uint32) assets.size();
+    const uint64 indexOffset = AssetPack::headerSize;
+    const uint64 stringsOffset = indexOffset + numEntries * AssetPack::indexEntrySize;
+    uint64 stringsSize = 0;
+    
+    for (const auto& asset: assets)
+        stringsSize += asset.name.getNumBytesAsUTF8();
+    
+    const uint64 dataOffset = alignUp(stringsOffset + stringsSize);
+    std::vector<uint64> entryOffsets;
+    uint64 fileSize = dataOffset;
+    
+    for (const auto& asset: assets)
+    {
+        entryOffsets.push_back(fileSize);
+        fileSize = alignUp(fileSize + asset.coords.size() * sizeof(float) + asset.verbs.size());
+    }
+    
+    MemoryBlock block((size_t) fileSize, true);
+    auto* bytes = static_cast<uint8*>(block.getData());
+    uint64 nameOffset = 0;
+    
+    for (uint32 i = 0; i < numEntries; ++i)
+    {
+        const auto& asset = assets[i];
+        uint8* data = bytes + entryOffsets[i];
+        
+        for (size_t c = 0; c < asset.coords.size(); ++c)
+        {
+            uint32 bits;
+            std::memcpy(&bits, &asset.coords[c], sizeof(bits));
+            put32(data + c * sizeof(float), bits);
+        }
+        
+        const size_t coordBytes = asset.coords.size() * sizeof(float);
+        std::copy(asset.verbs.begin(), asset.verbs.end(), data + coordBytes);
+        
+        const auto nameLength = asset.name.getNumBytesAsUTF8();
+        std::memcpy(bytes + stringsOffset + nameOffset, asset.name.toRawUTF8(), nameLength);
+        
+        uint8* entry = bytes + indexOffset + i * AssetPack::indexEntrySize;
+        put32(entry, asset.hash);
+        put32(entry + 4, (uint32) nameOffset);
+        put32(entry + 8, (uint32) nameLength);
+        put32(entry + 12, (uint32) asset.verbs.size());
+        put64(entry + 16, entryOffsets[i]);
+        put32(entry + 24, (uint32) asset.coords.size());
+        put32(entry + 28, AssetPack::checksum(data, coordBytes + asset.verbs.size()));
+        
+        nameOffset += nameLength;
+    }
+    
+    put32(bytes, AssetPack::magic);
+    put32(bytes + 4, AssetPack::version | ((uint32) AssetPack::headerSize << 16));
+    put32(bytes + 8, numEntries);
+    put32(bytes + 12, 0);
+    put64(bytes + 16, fileSize);
+    put64(bytes + 24, indexOffset);
+    put64(bytes + 32, stringsOffset);
+    put64(bytes + 40, dataOffset);
+    put32(bytes + 48, AssetPack::checksum(bytes + indexOffset, (size_t) (dataOffset - indexOffset)));
+    put32(bytes + 52, AssetPack::checksum(bytes, 52));
+    
+    return block;
+}
+
+bool AssetPackWriter::write(const File& file) const
+{
+    auto block = build();
+    return file.replaceWithData(block.getData(), block.getSize());
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreIncludes.h"
+#include "ShapeData.h"
+#include "Runtime/AssetPack.h"
+
+//! @brief writes converted shapes into a file that AssetPack can memory map and read in place
+class AssetPackWriter
+{
+public:
+    AssetPackWriter() {};
+    ~AssetPackWriter() {};
+    
+    //! @brief adds an asset, replacing any earlier asset of the same name
+    //! @arg name: the name the asset is looked up by
+    //! @arg shape: the parsed geometry, rectangles and ellipses stay compact verbs
+    void addAsset(const String& name, const ShapeData& shape);
+    int getNumAssets() const { return (int) assets.size(); }
+    
+    //! @brief lays out the header, index, names and aligned shape data
+    MemoryBlock build() const;
+    //! @brief builds the pack and writes it to a file
+    bool write(const File& file) const;
+    
+private:
+    struct Asset
+    {
+        String name;
+        uint32 hash;
+        std::vector<uint8> verbs;
+        std::vector<float> coords;
+    };
+    
+    std::vector<Asset> assets;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AssetPackWriter)
+};
@@ -0,0 +1,430 @@
+/*
+  ==============================================================================
+
+    Headless entry point, for converting svgs from build scripts.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SvgParser.h"
+#include "IconBundleWriter.h"
+#include "AssetPackWriter.h"
+#include "IconMipmapWriter.h"
+#include "SdfGenerator.h"
+#include "LayeredIconWriter.h"
+#include "AllocationStats.h"
+#include "Tracing.h"
+#include <iostream>
+
+//==============================================================================
+//! @brief returns the svg files named on the command line, expanding folders recursively
+//! @arg args: the arguments
+//! @arg optionsWithValues: options whose following argument is a value rather than an input
+static Array<File> getInputFiles(const ArgumentList& args, const StringArray& optionsWithValues)
+{
+    Array<File> files;
+    
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto arg = args[i];
+        
+        if (arg.isOption())
+        {
+            if (optionsWithValues.contains(arg.text.upToFirstOccurrenceOf("=", false, false))
+                && !arg.text.containsChar('='))
+                ++i;
+            
+            continue;
+        }
+        
+        auto file = arg.resolveAsFile();
+        
+        if (file.isDirectory())
+            files.addArray(file.findChildFiles(File::findFiles, true, "*.svg"));
+        else if (file.existsAsFile())
+            files.add(file);
+        else
+            ConsoleApplication::fail("No such file: " + arg.text);
+    }
+    
+    return files;
+}
+
+//! @brief prints what converting one file allocated, in builds with SVG2PATH_ALLOCATION_STATS
+//! @arg name: the file's name
+//! @arg before: the counts from before the conversion, whose peak was reset when they were taken
+static void printAllocations(const String& name, const AllocationStats::Counts& before)
+{
+    if (!AllocationStats::isEnabled)
+        return;
+    
+    // The peak heap is this conversion's, resident memory only has a peak over the process, so it is
+    // printed once at the end of the run
+    const auto counts = AllocationStats::getTotal() - before;
+    std::cout << name << ": " << counts.allocations << " allocations of " << File::descriptionOfSizeInBytes(counts.bytes)
+              << ", peak heap " << File::descriptionOfSizeInBytes(AllocationStats::getPeakHeapBytes()) << std::endl;
+}
+
+//! @brief prints the allocations of every stage and the peak resident memory over the whole run, in
+//! builds with SVG2PATH_ALLOCATION_STATS
+static void printAllocationStages()
+{
+    if (!AllocationStats::isEnabled)
+        return;
+    
+    std::cout << "Peak resident memory of the process "
+              << File::descriptionOfSizeInBytes(AllocationStats::getPeakResidentBytes()) << std::endl;
+    std::cout << "Allocations by stage" << std::endl;
+    
+    for (const auto& stage: AllocationStats::getStages())
+        if (stage.counts.allocations > 0)
+            std::cout << "  " << String(stage.name).paddedRight(' ', 26) << String(stage.counts.allocations).paddedLeft(' ', 10)
+                      << " allocations of " << File::descriptionOfSizeInBytes(stage.counts.bytes) << std::endl;
+}
+
+//! @brief prints the input the last parse skipped or ignored in a file
+static void printWarnings(const File& file, const SvgParser& parser)
+{
+    for (const auto& warning: parser.getWarnings())
+        std::cerr << file.getFullPathName() << ": " << warning << std::endl;
+}
+
+//! @brief converts each file, reporting the ones that fail, and hands the results on
+//! @arg files: the svg files to convert
+//! @arg parser: the parser to convert with
+//! @arg handleResult: called with the name, path and geometry of each converted file
+static void convertFiles(const Array<File>& files, SvgParser& parser,
+                         const std::function<void(const String&, const Path&, const ShapeData&)>& handleResult)
+{
+    if (files.isEmpty())
+        ConsoleApplication::fail("No svg files given");
+    
+    for (const auto& file: files)
+    {
+        SVG2PATH_TRACE_SCOPE("convertFile");
+        const auto allocationsBefore = AllocationStats::getTotal();
+        AllocationStats::resetPeak();
+        
+        Path path;
+        ShapeData shapes;
+        auto result = parser.parse(file.loadFileAsString(), path, shapes);
+        printWarnings(file, parser);
+        
+        if (path.isEmpty())
+        {
+            std::cerr << file.getFullPathName() << ": " << result << std::endl;
+            continue;
+        }
+        
+        printAllocations(file.getFileNameWithoutExtension(), allocationsBefore);
+        
+        handleResult(file.getFileNameWithoutExtension(), path, shapes);
+    }
+}
+
+//! @brief applies --flatten <size in pixels>, which bakes curves into lines for that render size
+static void setFlattening(const ArgumentList& args, SvgParser& parser)
+{
+    if (args.containsOption("--flatten"))
+        parser.setFlattening(args.getValueForOption("--flatten").getFloatValue());
+}
+
+//! @brief applies --merge, which unions overlapping shapes, and --clip, which applies clip paths
+static void setMerging(const ArgumentList& args, SvgParser& parser)
+{
+    parser.setMergeOverlaps(args.containsOption("--merge"));
+    parser.setApplyClipPaths(args.containsOption("--clip"));
+}
+
+//! @brief prints what merging saved for one icon, if it merged anything
+static void printMergeReport(const String& name, const SvgParser& parser)
+{
+    const auto& report = parser.getMergeReport();
+    if (report.numShapesMerged == 0)
+        return;
+    
+    std::cout << name << ": merged " << report.numShapesMerged << " shapes into " << report.numOutlines
+              << ", edges " << report.edgesBefore << " -> " << report.edgesAfter
+              << ", pixels filled " << roundToInt(report.pixelsBefore) << " -> " << roundToInt(report.pixelsAfter)
+              << " at 256px" << std::endl;
+}
+
+static void writeBundle(const ArgumentList& args)
+{
+    auto output = args.getFileForOption("--bundle");
+    auto files = getInputFiles(args, {"--bundle", "--binary-data", "--class", "--flatten"});
+    
+    SvgParser parser;
+    setFlattening(args, parser);
+    setMerging(args, parser);
+    IconBundleWriter bundle;
+    
+    convertFiles(files, parser, [&](const String& name, const Path& path, const ShapeData&) {
+        printMergeReport(name, parser);
+        bundle.addIcon(name, path);
+    });
+    
+    auto data = bundle.build();
+    
+    if (!output.replaceWithData(data.getData(), data.getSize()))
+        ConsoleApplication::fail("Could not write " + output.getFullPathName());
+    
+    std::cout << "Bundled " << bundle.getNumIcons() << " of " << files.size() << " icons, "
+              << (int) data.getSize() << " bytes" << std::endl;
+    
+    // Optionally wrap the bundle into BinaryData sources, using the same code the Projucer does
+    if (args.containsOption("--binary-data"))
+    {
+        auto folder = args.getFileForOption("--binary-data");
+        folder.createDirectory();
+        
+        build_tools::ResourceFile resources;
+        resources.setClassName(args.containsOption("--class") ? args.getValueForOption("--class") : "BinaryData");
+        resources.addFile(output);
+        
+        auto result = resources.write(0, "\n", folder.getChildFile(resources.getClassName() + ".h"),
+                                      [&](int index) {
+                                          return folder.getChildFile(resources.getClassName() + String(index + 1) + ".cpp");
+                                      });
+        
+        if (result.result.failed())
+            ConsoleApplication::fail(result.result.getErrorMessage());
+    }
+}
+
+static void writePack(const ArgumentList& args)
+{
+    auto output = args.getFileForOption("--pack");
+    auto files = getInputFiles(args, {"--pack", "--flatten"});
+    
+    SvgParser parser;
+    setFlattening(args, parser);
+    setMerging(args, parser);
+    AssetPackWriter pack;
+    
+    convertFiles(files, parser, [&](const String& name, const Path&, const ShapeData& shapes) {
+        printMergeReport(name, parser);
+        pack.addAsset(name, shapes);
+    });
+    
+    if (!pack.write(output))
+        ConsoleApplication::fail("Could not write " + output.getFullPathName());
+    
+    std::cout << "Packed " << pack.getNumAssets() << " of " << files.size() << " assets, "
+              << output.getSize() << " bytes" << std::endl;
+}
+
+static void writeMipmaps(const ArgumentList& args)
+{
+    auto output = args.getFileForOption("--mipmaps");
+    auto files = getInputFiles(args, {"--mipmaps", "--sizes", "--scales"});
+    
+    auto getList = [&](const String& option, const String& defaultValue) {
+        return StringArray::fromTokens(args.containsOption(option) ? args.getValueForOption(option) : defaultValue, ",", "");
+    };
+    
+    Array<int> sizes;
+    Array<float> scales;
+    
+    for (const auto& size: getList("--sizes", "16,24,32,48"))
+        sizes.add(size.getIntValue());
+    for (const auto& scale: getList("--scales", "1,2"))
+        scales.add(scale.getFloatValue());
+    
+    // Masks and fallback paths are baked in a unit square, so they line up at every size
+    SvgParser parser;
+    parser.setNormalisation(SvgParser::Normalisation::fit, 1.0f, 1.0f);
+    IconMipmapWriter mipmaps(sizes, scales);
+    
+    MemoryOutputStream out;
+    out << "#pragma once" << newLine << newLine;
+    int numIcons = 0;
+    
+    convertFiles(files, parser, [&](const String& name, const Path& path, const ShapeData&) {
+        auto identifier = build_tools::makeValidIdentifier(name, true, true, false);
+        auto fallback = path;
+        
+        out << mipmaps.getBinary(path, identifier) << parser.getBinary(fallback, identifier) << newLine;
+        ++numIcons;
+    });
+    
+    if (!output.replaceWithText(out.toString()))
+        ConsoleApplication::fail("Could not write " + output.getFullPathName());
+    
+    std::cout << "Baked " << numIcons << " of " << files.size() << " icons at "
+              << mipmaps.getPixelSizes().size() << " pixel sizes, " << output.getSize() << " bytes" << std::endl;
+}
+
+static void writeSdfs(const ArgumentList& args)
+{
+    auto output = args.getFileForOption("--sdf");
+    auto files = getInputFiles(args, {"--sdf", "--size", "--spread", "--compare"});
+    
+    const int size = args.containsOption("--size") ? args.getValueForOption("--size").getIntValue() : 64;
+    const float spread = args.containsOption("--spread") ? args.getValueForOption("--spread").getFloatValue() : 4.0f;
+    
+    if (size < 2 || spread <= 0.0f || spread * 2.0f >= (float) size)
+        ConsoleApplication::fail("The spread must be positive and less than half the size");
+    
+    Array<int> compareSizes;
+    if (args.containsOption("--compare"))
+        for (const auto& compareSize: StringArray::fromTokens(args.getValueForOption("--compare"), ",", ""))
+            compareSizes.add(compareSize.getIntValue());
+    
+    SvgParser parser;
+    parser.setNormalisation(SvgParser::Normalisation::fit, 1.0f, 1.0f);
+    SdfGenerator generator(size, spread);
+    
+    MemoryOutputStream out;
+    out << "#pragma once" << newLine << newLine;
+    int numIcons = 0;
+    
+    convertFiles(files, parser, [&](const String& name, const Path& path, const ShapeData&) {
+        auto field = generator.build(path);
+        
+        MemoryOutputStream code;
+        code << "static const unsigned char " << build_tools::makeValidIdentifier(name, true, true, false) << "Sdf[] = ";
+        build_tools::writeDataAsCppLiteral(field, code, false, true);
+        out << code.toString() << newLine << newLine;
+        ++numIcons;
+        
+        // Renders the field and the path at each size, to check the field is detailed enough
+        for (auto compareSize: compareSizes)
+        {
+            auto comparison = SdfGenerator::compare(path, field, compareSize);
+            std::cout << name << " at " << compareSize << "px: mean error " << String(comparison.meanError * 100.0f, 2)
+                      << "%, max error " << String(comparison.maxError * 100.0f, 1) << "%" << std::endl;
+        }
+    });
+    
+    if (!output.replaceWithText(out.toString()))
+        ConsoleApplication::fail("Could not write " + output.getFullPathName());
+    
+    std::cout << "Generated " << numIcons << " of " << files.size() << " distance fields, "
+              << output.getSize() << " bytes" << std::endl;
+}
+
+static void writeLayers(const ArgumentList& args)
+{
+    auto output = args.getFileForOption("--layers");
+    auto files = getInputFiles(args, {"--layers", "--flatten"});
+    
+    SvgParser parser;
+    setFlattening(args, parser);
+    setMerging(args, parser);
+    
+    if (files.isEmpty())
+        ConsoleApplication::fail("No svg files given");
+    
+    MemoryOutputStream out;
+    out << "#pragma once" << newLine << newLine;
+    int numIcons = 0, numLayers = 0;
+    
+    for (const auto& file: files)
+    {
+        SVG2PATH_TRACE_SCOPE("convertFile");
+        const auto allocationsBefore = AllocationStats::getTotal();
+        AllocationStats::resetPeak();
+        
+        std::vector<SvgParser::Layer> layers;
+        auto result = parser.parse(file.loadFileAsString(), layers);
+        printWarnings(file, parser);
+        
+        if (layers.empty())
+        {
+            std::cerr << file.getFullPathName() << ": " << result << std::endl;
+            continue;
+        }
+        
+        printAllocations(file.getFileNameWithoutExtension(), allocationsBefore);
+        
+        auto name = build_tools::makeValidIdentifier(file.getFileNameWithoutExtension(), true, true, false);
+        out << LayeredIconWriter::getBinary(layers, name) << newLine;
+        numLayers += (int) layers.size();
+        ++numIcons;
+    }
+    
+    if (!output.replaceWithText(out.toString()))
+        ConsoleApplication::fail("Could not write " + output.getFullPathName());
+    
+    std::cout << "Wrote " << numIcons << " of " << files.size() << " icons in " << numLayers << " layers, "
+              << output.getSize() << " bytes" << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    ConsoleApplication app;
+    app.addHelpCommand("--help|-h", "Usage:", true);
+    app.addVersionCommand("--version|-v", String(ProjectInfo::projectName) + " " + ProjectInfo::versionString);
+    
+    app.addCommand({"--bundle",
+                    "--bundle <output file> [--binary-data <folder>] [--class <name>] [--flatten <px>] [--merge] [--clip] <svg files or folders>...",
+                    "Packs many svgs into one icon bundle.",
+                    "Converts each svg and packs the paths into one blob with a hashed name index, which\n"
+                    "IconBundle reads without decoding the other icons. Icons are named after their files.\n"
+                    "With --binary-data the bundle is also written out as BinaryData sources. With --flatten\n"
+                    "curves are baked into lines for drawing at that many pixels. With --merge overlapping\n"
+                    "shapes are merged into one outline, and with --clip clip paths are applied.",
+                    writeBundle});
+    
+    app.addCommand({"--pack",
+                    "--pack <output file> [--flatten <px>] [--merge] [--clip] <svg files or folders>...",
+                    "Writes an asset pack that apps memory map at runtime.",
+                    "Converts each svg and writes its shapes into an aligned, checksummed file that\n"
+                    "AssetPack maps and decodes entry by entry. Assets are named after their files.",
+                    writePack});
+    
+    app.addCommand({"--mipmaps",
+                    "--mipmaps <output header> [--sizes 16,24,32,48] [--scales 1,2] <svg files or folders>...",
+                    "Bakes icons into alpha masks at fixed sizes.",
+                    "Rasterises each svg at every size and scale and writes the masks, with the path to fall\n"
+                    "back on at other sizes, as c++ arrays that IconMipmaps draws. Icons are named after their files.",
+                    writeMipmaps});
+    
+    app.addCommand({"--sdf",
+                    "--sdf <output header> [--size 64] [--spread 4] [--compare 16,32,64] <svg files or folders>...",
+                    "Generates signed distance fields of icons.",
+                    "Writes a size x size distance field of each svg as c++ arrays that SignedDistanceField\n"
+                    "draws at any size. With --compare, each field is rendered at the given sizes and\n"
+                    "compared with the vector render. Icons are named after their files.",
+                    writeSdfs});
+    
+    app.addCommand({"--layers",
+                    "--layers <output header> [--flatten <px>] [--merge] [--clip] <svg files or folders>...",
+                    "Converts coloured svgs into tables of paths grouped by paint.",
+                    "Reads each svg's fill, stroke, opacity and fill-rule, groups shapes that share a paint\n"
+                    "into layers and writes them as c++ arrays that LayeredIcon draws, with no xml to parse\n"
+                    "at runtime. Icons are named after their files.",
+                    writeLayers});
+    
+    // --trace <file> works with every command, so it is taken out before the command sees its arguments
+    ArgumentList args(argc, argv);
+    File traceFile;
+    
+    if (args.containsOption("--trace"))
+    {
+        traceFile = args.getFileForOption("--trace");
+        args.removeValueForOption("--trace");
+
+#if !SVG2PATH_TRACING
+        std::cerr << "Built without SVG2PATH_TRACING, the trace will be empty" << std::endl;
+#endif
+
+        Tracing::start();
+    }
+    
+    const int result = app.findAndRunCommand(args);
+    printAllocationStages();
+    
+    if (traceFile != File())
+    {
+        Tracing::stop();
+        
+        if (!Tracing::writeChromeTrace(traceFile))
+            std::cerr << "Could not write " << traceFile.getFullPathName() << std::endl;
+    }
+    
+    return result;
+}
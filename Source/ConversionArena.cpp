@@ -0,0 +1,112 @@
+#include "ConversionArena.h"
+
+ConversionArena::ConversionArena(size_t initialBlockSize) : initialBlockSize(jmax((size_t) 1024, initialBlockSize))
+{
+}
+
+ConversionArena::~ConversionArena()
+{
+    jassert(depth == 0);
+}
+
+void* ConversionArena::allocate(size_t size, size_t alignment)
+{
+    // Blocks are only as aligned as malloc makes them
+    jassert(alignment <= alignof(std::max_align_t) && isPowerOfTwo(alignment));
+    
+    auto getAligned = [alignment](size_t position) { return (position + alignment - 1) & ~(alignment - 1); };
+    
+    while (currentBlock < blocks.size())
+    {
+        auto& block = blocks[currentBlock];
+        const auto start = getAligned(blockPosition);
+        
+        if (start + size <= block.size)
+        {
+            blockPosition = start + size;
+            bytesUsed += size;
+            return block.data + start;
+        }
+        
+        ++currentBlock;
+        blockPosition = 0;
+    }
+    
+    // Each new block at least doubles what the arena holds, so a growing conversion needs few of them
+    Block block;
+    block.size = jmax(initialBlockSize, getCapacity(), size + alignment);
+    block.data.malloc(block.size);
+    blocks.push_back(std::move(block));
+    
+    currentBlock = blocks.size() - 1;
+    blockPosition = 0;
+    return allocate(size, alignment);
+}
+
+void ConversionArena::reset()
+{
+    if (blocks.size() > 1)
+    {
+        Block block;
+        block.size = getCapacity();
+        blocks.clear();
+        block.data.malloc(block.size);
+        blocks.push_back(std::move(block));
+    }
+    
+    currentBlock = 0;
+    blockPosition = 0;
+    bytesUsed = 0;
+}
+
+size_t ConversionArena::getCapacity() const
+{
+    size_t capacity = 0;
+    for (const auto& block: blocks)
+        capacity += block.size;
+    
+    return capacity;
+}
+
+ConversionArena& ConversionArena::getForThisThread()
+{
+    static thread_local ConversionArena arena;
+    return arena;
+}
+
+//==============================================================================
+ConversionArena::ScopedConversion::ScopedConversion() : arena(getForThisThread())
+{
+    ++arena.depth;
+}
+
+ConversionArena::ScopedConversion::~ScopedConversion()
+{
+    if (--arena.depth == 0)
+        arena.reset();
+}
+
+//==============================================================================
+ConversionArena::CodeOutputStream::CodeOutputStream(ConversionArena& arenaToUse) : arena(arenaToUse)
+{
+    jassert(!arena.outputInUse);
+    arena.outputInUse = true;
+}
+
+ConversionArena::CodeOutputStream::~CodeOutputStream()
+{
+    arena.outputInUse = false;
+}
+
+bool ConversionArena::CodeOutputStream::write(const void* data, size_t numBytes)
+{
+    if (size + numBytes > arena.outputCapacity)
+    {
+        arena.outputCapacity = jmax((size_t) 4096, arena.outputCapacity * 2, size + numBytes);
+        arena.outputBuffer.realloc(arena.outputCapacity);
+    }
+    
+    memcpy(arena.outputBuffer + size, data, numBytes);
+    size += numBytes;
+    return true;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "CoreIncludes.h"
+#include <vector>
+
+//! @brief a monotonic allocator for the temporaries of one conversion, released in one step
+//! Allocations bump a pointer through blocks taken from the heap, and are never freed one by one.
+//! Resetting lets everything go at once and keeps the memory for the next conversion. When a
+//! conversion needed more than one block, the reset replaces them with a single block of their
+//! combined size, so a batch settles on no heap allocations for the arena after its first files.
+//! Each thread has its own arena, so conversions on a thread pool share nothing.
+class ConversionArena
+{
+public:
+    explicit ConversionArena(size_t initialBlockSize = 64 * 1024);
+    ~ConversionArena();
+    
+    //! @brief returns uninitialised memory that stays valid until the next reset
+    void* allocate(size_t size, size_t alignment);
+    //! @brief releases everything allocated since the last reset, keeping the memory
+    void reset();
+    //! @brief returns the bytes handed out since the last reset
+    size_t getBytesUsed() const { return bytesUsed; }
+    //! @brief returns the bytes held from the heap
+    size_t getCapacity() const;
+    
+    //! @brief returns the calling thread's arena
+    static ConversionArena& getForThisThread();
+    
+    //! @brief marks the lifetime of one conversion on the calling thread's arena
+    //! The arena is reset when the outermost scope ends, so conversions that call each other share it.
+    //! Containers using the arena must be destroyed before the scope that was open when they were made.
+    class ScopedConversion
+    {
+    public:
+        ScopedConversion();
+        ~ScopedConversion();
+        
+        ConversionArena& getArena() { return arena; }
+        
+    private:
+        ConversionArena& arena;
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedConversion)
+    };
+    
+    //! @brief a stream for building generated code in the arena's output buffer, which keeps its
+    //! size between conversions, so only the finished string is allocated
+    //! One stream at a time can use an arena.
+    class CodeOutputStream : public OutputStream
+    {
+    public:
+        explicit CodeOutputStream(ConversionArena& arena);
+        ~CodeOutputStream() override;
+        
+        //! @brief returns what was written as a string
+        String toString() const { return String::fromUTF8(arena.outputBuffer, (int) size); }
+        
+        bool write(const void* data, size_t numBytes) override;
+        int64 getPosition() override { return (int64) size; }
+        bool setPosition(int64) override { return false; }
+        void flush() override {}
+        
+    private:
+        ConversionArena& arena;
+        size_t size{0};
+        
+        JUCE_DECLARE_NON_COPYABLE(CodeOutputStream)
+    };
+    
+private:
+    struct Block
+    {
+        HeapBlock<char> data;
+        size_t size;
+    };
+    
+    std::vector<Block> blocks;
+    size_t currentBlock{0};
+    size_t blockPosition{0};
+    size_t bytesUsed{0};
+    size_t initialBlockSize;
+    int depth{0};
+    HeapBlock<char> outputBuffer;
+    size_t outputCapacity{0};
+    bool outputInUse{false};
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConversionArena)
+};
+
+//==============================================================================
+//! @brief a standard allocator that takes memory from the calling thread's ConversionArena
+template <typename T>
+struct ArenaAllocator
+{
+    using value_type = T;
+    
+    ArenaAllocator() noexcept : arena(&ConversionArena::getForThisThread()) {}
+    template <typename Other>
+    ArenaAllocator(const ArenaAllocator<Other>& other) noexcept : arena(other.arena) {}
+    
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) noexcept {}
+    
+    template <typename Other>
+    bool operator==(const ArenaAllocator<Other>& other) const noexcept { return arena == other.arena; }
+    template <typename Other>
+    bool operator!=(const ArenaAllocator<Other>& other) const noexcept { return arena != other.arena; }
+    
+    ConversionArena* arena;
+};
+
+//! @brief a vector whose storage lives in the calling thread's ConversionArena
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,8 @@
+#pragma once
+
+// The converter core is built as a library without a generated JuceHeader.h, so it includes the
+// modules it uses directly. They are compiled once into Svg2PathJuce, which it links
+#include <juce_graphics/juce_graphics.h>
+#include <juce_build_tools/juce_build_tools.h>
+
+using namespace juce;
@@ -0,0 +1,83 @@
+#include "IconBundleWriter.h"
+#include "Runtime/NameHash.h"
+
+void IconBundleWriter::addIcon(const String& name, const Path& path)
+{
+    MemoryOutputStream data;
+    path.writePathToStream(data);
+    
+    // Keep the icons sorted by name, so the entry table comes out in a stable order
+    auto it = std::lower_bound(icons.begin(), icons.end(), name,
+                               [](const Icon& icon, const String& n) { return icon.name < n; });
+    
+    if (it != icons.end() && it->name == name)
+        it->data = data.getMemoryBlock();
+    else
+        icons.insert(it, {name, data.getMemoryBlock()});
+}
+
+MemoryBlock IconBundleWriter::build() const
+{
+    const auto numIcons = (uint32) icons.size();
+    
+    // At most half the slots are used, which keeps the probe sequences short
+    uint32 numSlots = 1;
+    while (numSlots < numIcons * 2 + 1)
+        numSlots <<= 1;
+    
+    const uint32 entriesStart = (uint32) (IconBundle::headerSize + numSlots * 4);
+    uint32 namesStart = entriesStart + numIcons * (uint32) IconBundle::entrySize;
+    uint32 payloadStart = namesStart;
+    
+    for (const auto& icon: icons)
+        payloadStart += (uint32) icon.name.getNumBytesAsUTF8();
+    
+    std::vector<uint32> slots(numSlots, 0);
+    MemoryOutputStream entries, names, payloads;
+    
+    for (uint32 i = 0; i < numIcons; ++i)
+    {
+        const auto& icon = icons[i];
+        const auto* utf8 = icon.name.toRawUTF8();
+        const auto nameLength = (uint32) icon.name.getNumBytesAsUTF8();
+        const uint32 hash = NameHash::compute(utf8, nameLength);
+        
+        uint32 slot = hash & (numSlots - 1);
+        while (slots[slot] != 0)
+            slot = (slot + 1) & (numSlots - 1);
+        slots[slot] = i + 1;
+        
+        entries.writeInt((int) hash);
+        entries.writeInt((int) (namesStart + names.getDataSize()));
+        entries.writeInt((int) nameLength);
+        entries.writeInt((int) (payloadStart + payloads.getDataSize()));
+        entries.writeInt((int) icon.data.getSize());
+        
+        names.write(utf8, nameLength);
+        payloads << icon.data;
+    }
+    
+    MemoryOutputStream out;
+    out.writeInt((int) IconBundle::magic);
+    out.writeShort((short) IconBundle::version);
+    out.writeShort(0);
+    out.writeInt((int) numIcons);
+    out.writeInt((int) numSlots);
+    
+    for (auto slot: slots)
+        out.writeInt((int) slot);
+    
+    out << entries.getMemoryBlock() << names.getMemoryBlock() << payloads.getMemoryBlock();
+    
+    return out.getMemoryBlock();
+}
+
+String IconBundleWriter::getBinary(const String& name) const
+{
+    MemoryOutputStream out;
+    out << "static const unsigned char " << (name.isNotEmpty() ? name : String("icon")) << "BundleData[] = ";
+    build_tools::writeDataAsCppLiteral(build(), out, false, true);
+    out << newLine;
+    
+    return out.toString();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreIncludes.h"
+#include "Runtime/IconBundle.h"
+
+//! @brief packs many converted paths into one blob that IconBundle can index and decode lazily
+class IconBundleWriter
+{
+public:
+    IconBundleWriter() {};
+    ~IconBundleWriter() {};
+    
+    //! @brief adds an icon, replacing any earlier icon of the same name
+    //! @arg name: the name the icon is looked up by
+    //! @arg path: the path to store, serialised as SvgParser::getBinary does
+    void addIcon(const String& name, const Path& path);
+    int getNumIcons() const { return (int) icons.size(); }
+    
+    //! @brief lays out the header, name index and payloads
+    MemoryBlock build() const;
+    //! @brief returns the bundle as a c++ array
+    //! @arg name: an optional name for the exported array
+    String getBinary(const String& name) const;
+    
+private:
+    struct Icon
+    {
+        String name;
+        MemoryBlock data;
+    };
+    
+    std::vector<Icon> icons;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IconBundleWriter)
+};
@@ -0,0 +1,99 @@
+#include "IconMipmapWriter.h"
+
+IconMipmapWriter::IconMipmapWriter(const Array<int>& sizes, const Array<float>& scales)
+{
+    for (auto size: sizes)
+        for (auto scale: scales)
+            if (roundToInt((float) size * scale) > 0)
+                pixelSizes.addIfNotAlreadyThere(roundToInt((float) size * scale));
+    
+    pixelSizes.sort();
+}
+
+Image IconMipmapWriter::rasterise(const Path& path, int pixelSize)
+{
+    Image mask(Image::SingleChannel, pixelSize, pixelSize, true, SoftwareImageType());
+    
+    Graphics g(mask);
+    g.setColour(Colours::white);
+    g.fillPath(path, AffineTransform::scale((float) pixelSize));
+    
+    return mask;
+}
+
+void IconMipmapWriter::encodeMask(const Image& mask, MemoryOutputStream& out)
+{
+    const Image::BitmapData bitmap(mask, Image::BitmapData::readOnly);
+    
+    for (int y = 0; y < bitmap.height; ++y)
+    {
+        const auto* line = bitmap.getLinePointer(y);
+        auto pixel = [&](int x) { return line[x * bitmap.pixelStride]; };
+        
+        // Runs never cross rows, icons are mostly long runs of 0 and 255 with short antialiased edges
+        int x = 0;
+        while (x < bitmap.width)
+        {
+            int run = 1;
+            while (x + run < bitmap.width && run < 128 && pixel(x + run) == pixel(x))
+                ++run;
+            
+            if (run > 1)
+            {
+                out.writeByte((char) (257 - run));
+                out.writeByte((char) pixel(x));
+                x += run;
+                continue;
+            }
+            
+            // Collect literals up to the next pair of equal bytes
+            int count = 1;
+            while (x + count < bitmap.width && count < 128
+                   && !(x + count + 1 < bitmap.width && pixel(x + count) == pixel(x + count + 1)))
+                ++count;
+            
+            out.writeByte((char) (count - 1));
+            for (int i = 0; i < count; ++i)
+                out.writeByte((char) pixel(x + i));
+            
+            x += count;
+        }
+    }
+}
+
+MemoryBlock IconMipmapWriter::build(const Path& path) const
+{
+    const auto numMips = (uint32) pixelSizes.size();
+    const auto masksStart = (uint32) (IconMipmaps::headerSize + numMips * IconMipmaps::mipEntrySize);
+    
+    MemoryOutputStream entries, masks;
+    
+    for (auto size: pixelSizes)
+    {
+        const auto offset = (uint32) masks.getDataSize();
+        encodeMask(rasterise(path, size), masks);
+        
+        entries.writeShort((short) size);
+        entries.writeShort(0);
+        entries.writeInt((int) (masksStart + offset));
+        entries.writeInt((int) (masks.getDataSize() - offset));
+    }
+    
+    MemoryOutputStream out;
+    out.writeInt((int) IconMipmaps::magic);
+    out.writeShort((short) IconMipmaps::version);
+    out.writeShort((short) numMips);
+    out << entries.getMemoryBlock() << masks.getMemoryBlock();
+    
+    return out.getMemoryBlock();
+}
+
+String IconMipmapWriter::getBinary(const Path& path, const String& name) const
+{
+    MemoryOutputStream out;
+    out << "static const unsigned char " << (name.isNotEmpty() ? name : String("icon")) << "Mipmaps[] = ";
+    build_tools::writeDataAsCppLiteral(build(path), out, false, true);
+    out << newLine;
+    
+    return out.toString();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreIncludes.h"
+#include "Runtime/IconMipmaps.h"
+
+//! @brief rasterises an icon at fixed sizes into alpha masks that IconMipmaps blits at runtime
+class IconMipmapWriter
+{
+public:
+    //! @arg sizes: the logical sizes the icon is drawn at
+    //! @arg scales: the display scale factors to bake each size for
+    IconMipmapWriter(const Array<int>& sizes = {16, 24, 32, 48}, const Array<float>& scales = {1.0f, 2.0f});
+    ~IconMipmapWriter() {};
+    
+    //! @brief returns the distinct physical sizes, as sizes at different scales often coincide
+    const Array<int>& getPixelSizes() const { return pixelSizes; }
+    
+    //! @brief rasterises a path at every size
+    //! @arg path: the icon normalised to a unit square
+    MemoryBlock build(const Path& path) const;
+    //! @brief returns the masks as a c++ array
+    //! @arg path: the icon normalised to a unit square
+    //! @arg name: an optional name for the exported array
+    String getBinary(const Path& path, const String& name) const;
+    
+    //! @brief fills a path into a square single channel image with the software renderer
+    static Image rasterise(const Path& path, int pixelSize);
+    //! @brief PackBits encodes the pixels of a single channel image
+    static void encodeMask(const Image& mask, MemoryOutputStream& out);
+    
+private:
+    Array<int> pixelSizes;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IconMipmapWriter)
+};
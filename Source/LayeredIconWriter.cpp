@@ -0,0 +1,41 @@
+#include "LayeredIconWriter.h"
+
+MemoryBlock LayeredIconWriter::build(const std::vector<SvgParser::Layer>& layers)
+{
+    MemoryOutputStream out;
+    out.writeInt((int) LayeredIcon::magic);
+    out.writeShort((short) LayeredIcon::version);
+    out.writeShort((short) jmin((size_t) 0xffff, layers.size()));
+    
+    for (size_t i = 0; i < layers.size() && i < 0xffff; ++i)
+    {
+        const auto& layer = layers[i];
+        
+        out.writeInt((int) layer.colour.getARGB());
+        out.writeShort((short) (layer.nonZeroWinding ? 0 : LayeredIcon::evenOddFill));
+        out.writeShort(0);
+        out.writeInt((int) layer.shape.verbs.size());
+        out.writeInt((int) layer.shape.coords.size());
+        
+        for (auto coord: layer.shape.coords)
+            out.writeFloat(coord);
+        
+        out.write(layer.shape.verbs.data(), layer.shape.verbs.size());
+        
+        // Pad the verbs so the next layer's coords stay aligned
+        for (auto padding = layer.shape.verbs.size(); padding % 4 != 0; ++padding)
+            out.writeByte(0);
+    }
+    
+    return out.getMemoryBlock();
+}
+
+String LayeredIconWriter::getBinary(const std::vector<SvgParser::Layer>& layers, const String& name)
+{
+    MemoryOutputStream out;
+    out << "static const unsigned char " << (name.isNotEmpty() ? name : String("icon")) << "Layers[] = ";
+    build_tools::writeDataAsCppLiteral(build(layers), out, false, true);
+    out << newLine;
+    
+    return out.toString();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreIncludes.h"
+#include "SvgParser.h"
+#include "Runtime/LayeredIcon.h"
+
+//! @brief writes the layers SvgParser groups by paint into a table that LayeredIcon reads
+class LayeredIconWriter
+{
+public:
+    //! @brief serialises the layers, keeping their primitives compact
+    static MemoryBlock build(const std::vector<SvgParser::Layer>& layers);
+    //! @brief returns the table as a c++ array
+    //! @arg layers: the layers to write
+    //! @arg name: an optional name for the exported array
+    static String getBinary(const std::vector<SvgParser::Layer>& layers, const String& name);
+};
@@ -8,6 +8,7 @@
 
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "Tracing.h"
 
 //==============================================================================
 class Svg2PathApplication  : public juce::JUCEApplication
@@ -25,6 +26,15 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
+        // --trace <file> records every conversion until the app quits
+        juce::ArgumentList args (getApplicationName(), commandLine);
+
+        if (args.containsOption ("--trace"))
+        {
+            traceFile = args.getFileForOption ("--trace");
+            Tracing::start();
+        }
+
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
 
@@ -33,6 +43,12 @@ public:
         // Add your application's shutdown code here..
 
         mainWindow = nullptr; // (deletes our window)
+
+        if (traceFile != juce::File())
+        {
+            Tracing::stop();
+            Tracing::writeChromeTrace (traceFile);
+        }
     }
 
     //==============================================================================
@@ -98,6 +114,7 @@ public:
 
 private:
     std::unique_ptr<MainWindow> mainWindow;
+    juce::File traceFile;
 };
 
 //==============================================================================
@@ -20,6 +20,36 @@ codeEditor(codeDoc, &cppTokenizer)
     pathNameEditor.setColour(TextEditor::backgroundColourId, Colour(0xff001122));
     pathNameEditor.addListener(this);
     
+    addAndMakeVisible(normalisationBox);
+    normalisationBox.addItemList({"SVG units", "Unit square", "Target size", "Fit target size"}, 1);
+    normalisationBox.setSelectedId(1, NotificationType::dontSendNotification);
+    normalisationBox.onChange = [this] { parseSVG(); };
+    
+    addAndMakeVisible(targetSizeEditor);
+    targetSizeEditor.setSelectAllWhenFocused(true);
+    targetSizeEditor.setTextToShowWhenEmpty("24x24", Colour(0x55dddddd));
+    targetSizeEditor.setColour(TextEditor::backgroundColourId, Colour(0xff001122));
+    targetSizeEditor.addListener(this);
+    
+    addAndMakeVisible(outputModeBox);
+    outputModeBox.addItemList({"Single path", "Path per element", "Colour layers"}, 1);
+    outputModeBox.setSelectedId(1, NotificationType::dontSendNotification);
+    outputModeBox.onChange = [this] { parseSVG(); };
+    
+    addAndMakeVisible(flattenSizeEditor);
+    flattenSizeEditor.setSelectAllWhenFocused(true);
+    flattenSizeEditor.setTextToShowWhenEmpty("Flatten at px", Colour(0x55dddddd));
+    flattenSizeEditor.setColour(TextEditor::backgroundColourId, Colour(0xff001122));
+    flattenSizeEditor.addListener(this);
+    
+    addAndMakeVisible(mergeButton);
+    mergeButton.setButtonText("Merge");
+    mergeButton.onClick = [this] { parseSVG(); };
+    
+    addAndMakeVisible(clipButton);
+    clipButton.setButtonText("Clip");
+    clipButton.onClick = [this] { parseSVG(); };
+    
     svgEditor.setColourScheme(getColourScheme());
     svgEditor.setColour(CodeEditorComponent::backgroundColourId, Colour(0xff001122));
     codeEditor.setColourScheme(getColourScheme());
@@ -42,6 +72,15 @@ MainComponent::~MainComponent()
 void MainComponent::paint(juce::Graphics& g)
 {
     g.fillAll(Colour(isDragging ? 0xff223344 : 0xff112233));
+    
+    // Layers are previewed in their own colours, everything else in white
+    if (icon.getNumLayers() > 0)
+    {
+        icon.draw(g);
+        icon.draw(g, xform);
+        return;
+    }
+    
     g.setColour(juce::Colours::white);
     g.fillPath(path);
     g.fillPath(path, xform);
@@ -53,7 +92,13 @@ void MainComponent::resized()
     int ww = getWidth() / 2;
     
     pathNameEditor.setBounds(0, hh, 150, 20);
-    svgLabel.setBounds(160, hh, getWidth() - 170, 20);
+    normalisationBox.setBounds(160, hh, 130, 20);
+    targetSizeEditor.setBounds(300, hh, 70, 20);
+    outputModeBox.setBounds(380, hh, 130, 20);
+    flattenSizeEditor.setBounds(520, hh, 90, 20);
+    mergeButton.setBounds(620, hh, 70, 20);
+    clipButton.setBounds(690, hh, 60, 20);
+    svgLabel.setBounds(760, hh, getWidth() - 770, 20);
     svgEditor.setBounds(0, hh + 20, getWidth(), hh - 20);
     
     int y = hh + hh;
@@ -72,10 +117,46 @@ void MainComponent::parseSVG()
     pathDataEditor.clear();
     path.clear();
     String name = pathNameEditor.getText();
-    String juceCode = parser.parse(svgDoc.getAllContent(), path);
-    String binData = parser.getBinary(path, name);
     
-    // Output the generated JUCE code
+    auto size = StringArray::fromTokens(targetSizeEditor.getText(), "x, ", "");
+    size.removeEmptyStrings();
+    float targetWidth = size.isEmpty() ? 24.0f : size[0].getFloatValue();
+    float targetHeight = size.size() < 2 ? targetWidth : size[1].getFloatValue();
+    
+    SvgParser::Options options;
+    options.normalisation = (SvgParser::Normalisation) normalisationBox.getSelectedItemIndex();
+    options.targetWidth = targetWidth;
+    options.targetHeight = targetHeight;
+    options.outputMode = (SvgParser::OutputMode) outputModeBox.getSelectedItemIndex();
+    options.flatteningSize = flattenSizeEditor.getText().getFloatValue();
+    options.mergeOverlaps = mergeButton.getToggleState();
+    options.applyClipPaths = clipButton.getToggleState();
+    
+    auto conversion = SvgParser::convert(svgDoc.getAllContent(), options);
+    path = conversion.path;
+    
+    String binData;
+    icon = {};
+    
+    if (options.outputMode == SvgParser::OutputMode::layers)
+    {
+        // The preview reads the same table the app will, to show what it will draw
+        binData = LayeredIconWriter::getBinary(conversion.layers, name);
+        
+        auto table = LayeredIconWriter::build(conversion.layers);
+        icon = LayeredIcon(table.getData(), table.getSize());
+    }
+    else
+    {
+        binData = SvgParser(options).getBinary(path, name);
+    }
+    
+    // Output the generated JUCE code, with what was ignored in the svg above it
+    String juceCode;
+    for (const auto& warning: conversion.warnings)
+        juceCode << "// " << warning << "\n";
+    
+    juceCode << (conversion.wasSuccessful() ? conversion.code : conversion.error);
     codeEditor.loadContent(juceCode);
     
     pathDataEditor.setText(binData);
@@ -2,12 +2,11 @@
 
 #include <JuceHeader.h>
 #include "SvgParser.h"
+#include "LayeredIconWriter.h"
 
 class MainComponent: public Component, public TextEditor::Listener,
 public CodeDocument::Listener, public FileDragAndDropTarget
 {
-    SvgParser parser;
-    
     XmlTokeniser xmlTokenizer;
     CodeDocument svgDoc;
     CodeEditorComponent svgEditor;
@@ -17,7 +16,14 @@ public CodeDocument::Listener, public FileDragAndDropTarget
     CodeEditorComponent codeEditor;
     TextEditor pathDataEditor;
     TextEditor pathNameEditor;
+    ComboBox normalisationBox;
+    TextEditor targetSizeEditor;
+    ComboBox outputModeBox;
+    TextEditor flattenSizeEditor;
+    ToggleButton mergeButton;
+    ToggleButton clipButton;
     Path path;
+    LayeredIcon icon;
     Label svgLabel;
     Label codeLabel;
     Label pathDataLabel;
@@ -0,0 +1,318 @@
+#include "PathBoolean.h"
+#include <array>
+#include <map>
+
+ShapeData PathBoolean::getUnion(const std::vector<ShapeData>& shapes, float tolerance)
+{
+    std::vector<Operand> operands;
+    for (const auto& shape: shapes)
+        operands.push_back({&shape, true});
+    
+    return combine(operands, [](const std::vector<bool>& inside) {
+        return std::find(inside.begin(), inside.end(), true) != inside.end();
+    }, tolerance);
+}
+
+ShapeData PathBoolean::getIntersection(const ShapeData& shape, bool nonZeroWinding, const ShapeData& clip,
+                                       bool clipNonZeroWinding, float tolerance)
+{
+    return combine({{&shape, nonZeroWinding}, {&clip, clipNonZeroWinding}},
+                   [](const std::vector<bool>& inside) { return inside[0] && inside[1]; }, tolerance);
+}
+
+int PathBoolean::countEdges(const ShapeData& shape, float tolerance)
+{
+    std::vector<Edge> edges;
+    addEdges(shape, 0, tolerance, edges);
+    return (int) edges.size();
+}
+
+double PathBoolean::getCoverage(const ShapeData& shape, const Rectangle<float>& area, int pixelSize)
+{
+    if (shape.isEmpty() || area.isEmpty())
+        return 0.0;
+    
+    Path path;
+    shape.appendTo(path);
+    
+    Image image(Image::SingleChannel, pixelSize, pixelSize, true, SoftwareImageType());
+    {
+        Graphics g(image);
+        g.fillPath(path, RectanglePlacement(RectanglePlacement::centred)
+                             .getTransformToFit(area, image.getBounds().toFloat()));
+    }
+    
+    double coverage = 0.0;
+    Image::BitmapData pixels(image, Image::BitmapData::readOnly);
+    
+    for (int y = 0; y < pixelSize; ++y)
+        for (int x = 0; x < pixelSize; ++x)
+            coverage += *pixels.getPixelPointer(x, y) / 255.0;
+    
+    return coverage;
+}
+
+void PathBoolean::addEdges(const ShapeData& shape, int owner, float tolerance, std::vector<Edge>& edges)
+{
+    Path path;
+    shape.appendTo(path);
+    
+    // The flattening iterator closes every sub-path, as filling does
+    for (PathFlatteningIterator it(path, {}, tolerance); it.next();)
+        if (it.x1 != it.x2 || it.y1 != it.y2)
+            edges.push_back({{it.x1, it.y1}, {it.x2, it.y2}, owner});
+}
+
+std::vector<PathBoolean::Edge> PathBoolean::splitEdges(const std::vector<Edge>& edges, double snap)
+{
+    auto cross = [](Point<double> a, Point<double> b) { return a.x * b.y - a.y * b.x; };
+    std::vector<std::vector<double>> splits(edges.size());
+    
+    // Sweep along x, so only edges whose x ranges overlap are tested against each other
+    std::vector<size_t> order(edges.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    
+    auto minX = [&](size_t i) { return jmin(edges[i].start.x, edges[i].end.x); };
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return minX(a) < minX(b); });
+    
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const auto& a = edges[order[i]];
+        const auto r = a.end - a.start;
+        const double lengthA = r.getDistanceFromOrigin();
+        const double maxX = jmax(a.start.x, a.end.x) + snap;
+        
+        for (size_t j = i + 1; j < order.size() && minX(order[j]) <= maxX; ++j)
+        {
+            const auto& b = edges[order[j]];
+            
+            if (jmax(b.start.y, b.end.y) < jmin(a.start.y, a.end.y) - snap
+                || jmin(b.start.y, b.end.y) > jmax(a.start.y, a.end.y) + snap)
+                continue;
+            
+            const auto s = b.end - b.start;
+            const auto offset = b.start - a.start;
+            const double lengthB = s.getDistanceFromOrigin();
+            const double epsA = snap / lengthA, epsB = snap / lengthB;
+            const double denominator = cross(r, s);
+            
+            auto addSplit = [&](size_t edge, double t, double eps) {
+                if (t > eps && t < 1.0 - eps)
+                    splits[edge].push_back(t);
+            };
+            
+            if (std::abs(denominator) > 1.0e-12 * lengthA * lengthB)
+            {
+                const double t = cross(offset, s) / denominator;
+                const double u = cross(offset, r) / denominator;
+                
+                if (t >= -epsA && t <= 1.0 + epsA && u >= -epsB && u <= 1.0 + epsB)
+                {
+                    addSplit(order[i], t, epsA);
+                    addSplit(order[j], u, epsB);
+                }
+            }
+            else if (std::abs(cross(offset, r)) / lengthA < snap)
+            {
+                // Overlapping collinear edges are split at each other's ends, so the shared part
+                // becomes the same edge in both
+                addSplit(order[i], (b.start - a.start).getDotProduct(r) / (lengthA * lengthA), epsA);
+                addSplit(order[i], (b.end - a.start).getDotProduct(r) / (lengthA * lengthA), epsA);
+                addSplit(order[j], (a.start - b.start).getDotProduct(s) / (lengthB * lengthB), epsB);
+                addSplit(order[j], (a.end - b.start).getDotProduct(s) / (lengthB * lengthB), epsB);
+            }
+        }
+    }
+    
+    // Snap every point to a grid, so points shared between edges compare equal
+    auto snapPoint = [snap](Point<double> p) {
+        return Point<double>(std::round(p.x / snap) * snap, std::round(p.y / snap) * snap);
+    };
+    
+    std::vector<Edge> result;
+    result.reserve(edges.size() * 2);
+    
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        auto& ts = splits[i];
+        std::sort(ts.begin(), ts.end());
+        ts.push_back(1.0);
+        
+        const auto& edge = edges[i];
+        auto start = snapPoint(edge.start);
+        
+        for (auto t: ts)
+        {
+            const auto end = snapPoint(edge.start + (edge.end - edge.start) * t);
+            if (end != start)
+                result.push_back({start, end, edge.owner});
+            start = end;
+        }
+    }
+    
+    return result;
+}
+
+ShapeData PathBoolean::chainEdges(const std::vector<Edge>& edges, double snap)
+{
+    auto getKey = [snap](Point<double> p) {
+        return std::make_pair((int64) std::llround(p.x / snap), (int64) std::llround(p.y / snap));
+    };
+    
+    std::multimap<std::pair<int64, int64>, size_t> starts;
+    for (size_t i = 0; i < edges.size(); ++i)
+        starts.insert({getKey(edges[i].start), i});
+    
+    std::vector<bool> used(edges.size(), false);
+    ShapeData result;
+    
+    for (size_t first = 0; first < edges.size(); ++first)
+    {
+        if (used[first])
+            continue;
+        
+        // Follow edges end to start until the loop comes back round
+        std::vector<Point<double>> loop{edges[first].start};
+        const auto loopStart = getKey(edges[first].start);
+        size_t current = first;
+        
+        while (true)
+        {
+            used[current] = true;
+            const auto endKey = getKey(edges[current].end);
+            
+            if (endKey == loopStart)
+                break;
+            
+            loop.push_back(edges[current].end);
+            
+            auto range = starts.equal_range(endKey);
+            auto next = std::find_if(range.first, range.second, [&](const auto& entry) { return !used[entry.second]; });
+            
+            if (next == range.second)
+                break;
+            
+            current = next->second;
+        }
+        
+        // Drop points that lie on the line between their neighbours
+        for (bool removed = true; removed && loop.size() >= 3;)
+        {
+            removed = false;
+            
+            for (size_t i = 0; i < loop.size() && loop.size() >= 3; ++i)
+            {
+                const auto& previous = loop[(i + loop.size() - 1) % loop.size()];
+                const auto& next = loop[(i + 1) % loop.size()];
+                const auto d1 = loop[i] - previous, d2 = next - loop[i];
+                
+                if (std::abs(d1.x * d2.y - d1.y * d2.x) <= snap * (next - previous).getDistanceFromOrigin()
+                    && d1.getDotProduct(d2) >= 0.0)
+                {
+                    loop.erase(loop.begin() + (std::ptrdiff_t) i);
+                    removed = true;
+                }
+            }
+        }
+        
+        if (loop.size() < 3)
+            continue;
+        
+        result.startNewSubPath((float) loop[0].x, (float) loop[0].y);
+        for (size_t i = 1; i < loop.size(); ++i)
+            result.lineTo((float) loop[i].x, (float) loop[i].y);
+        result.closeSubPath();
+    }
+    
+    return result;
+}
+
+ShapeData PathBoolean::combine(const std::vector<Operand>& operands,
+                               const std::function<bool(const std::vector<bool>&)>& isInside, float tolerance)
+{
+    std::vector<Edge> edges;
+    for (size_t i = 0; i < operands.size(); ++i)
+        addEdges(*operands[i].shape, (int) i, tolerance, edges);
+    
+    if (edges.empty())
+        return {};
+    
+    Rectangle<double> bounds(edges[0].start, edges[0].end);
+    for (const auto& edge: edges)
+        bounds = bounds.getUnion(Rectangle<double>(edge.start, edge.end));
+    
+    // The snapping grid sits well below float precision of the output, the side samples a little further out
+    const double size = jmax(bounds.getWidth(), bounds.getHeight(), 1.0e-6);
+    const double snap = size * 1.0e-6;
+    const double sampleOffset = size * 1.0e-5;
+    
+    // Bucket the edges into horizontal bands, so a winding number only looks at edges that can cross its ray
+    const int numBands = jlimit(1, 1024, (int) edges.size() / 4);
+    const double bandHeight = bounds.getHeight() / numBands + 1.0e-12;
+    std::vector<std::vector<size_t>> bands((size_t) numBands);
+    
+    auto getBand = [&](double y) { return jlimit(0, numBands - 1, (int) ((y - bounds.getY()) / bandHeight)); };
+    
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        const int firstBand = getBand(jmin(edges[i].start.y, edges[i].end.y));
+        const int lastBand = getBand(jmax(edges[i].start.y, edges[i].end.y));
+        for (int band = firstBand; band <= lastBand; ++band)
+            bands[(size_t) band].push_back(i);
+    }
+    
+    std::vector<int> windings(operands.size());
+    std::vector<bool> inside(operands.size());
+    
+    auto isCovered = [&](Point<double> p) {
+        std::fill(windings.begin(), windings.end(), 0);
+        
+        for (auto index: bands[(size_t) getBand(p.y)])
+        {
+            const auto& edge = edges[index];
+            const double side = (edge.end.x - edge.start.x) * (p.y - edge.start.y)
+                              - (p.x - edge.start.x) * (edge.end.y - edge.start.y);
+            
+            if (edge.start.y <= p.y && edge.end.y > p.y && side > 0.0)
+                ++windings[(size_t) edge.owner];
+            else if (edge.start.y > p.y && edge.end.y <= p.y && side < 0.0)
+                --windings[(size_t) edge.owner];
+        }
+        
+        for (size_t i = 0; i < windings.size(); ++i)
+            inside[i] = operands[i].nonZeroWinding ? windings[i] != 0 : (windings[i] & 1) != 0;
+        
+        return isInside(inside);
+    };
+    
+    // Edges shared by several shapes are classified once
+    auto pieces = splitEdges(edges, snap);
+    std::map<std::array<int64, 4>, size_t> unique;
+    std::vector<Edge> kept;
+    
+    for (const auto& piece: pieces)
+    {
+        auto a = std::make_pair((int64) std::llround(piece.start.x / snap), (int64) std::llround(piece.start.y / snap));
+        auto b = std::make_pair((int64) std::llround(piece.end.x / snap), (int64) std::llround(piece.end.y / snap));
+        if (b < a)
+            std::swap(a, b);
+        
+        if (!unique.insert({{a.first, a.second, b.first, b.second}, 0}).second)
+            continue;
+        
+        // Keep an edge only where the result is filled on one side of it, turned so that side is on its left
+        const auto direction = piece.end - piece.start;
+        const auto normal = Point<double>(-direction.y, direction.x) / direction.getDistanceFromOrigin();
+        const auto middle = (piece.start + piece.end) * 0.5;
+        const bool left = isCovered(middle + normal * sampleOffset);
+        const bool right = isCovered(middle - normal * sampleOffset);
+        
+        if (left && !right)
+            kept.push_back(piece);
+        else if (right && !left)
+            kept.push_back({piece.end, piece.start, piece.owner});
+    }
+    
+    return chainEdges(kept, snap);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreIncludes.h"
+#include "ShapeData.h"
+
+//! @brief union and intersection of filled shapes, on their flattened outlines
+//! Every edge is split where it crosses or touches another, then kept only if the result
+//! is filled on exactly one side of it. The kept edges are turned so the filled side is on
+//! the same side as for Path::addRectangle, and chained into loops, which fill the same area
+//! under either rule. Each shape is filled with its own rule, so shapes may overlap themselves
+//! and each other in any direction.
+class PathBoolean
+{
+public:
+    //! @brief returns the outline of the area covered by any of the shapes
+    //! @arg shapes: the shapes to merge, each filled with the non-zero rule
+    //! @arg tolerance: the flattening tolerance for curves, in the shapes' units
+    static ShapeData getUnion(const std::vector<ShapeData>& shapes, float tolerance);
+    //! @brief returns the outline of the area covered by both shapes
+    //! @arg shape: the shape to clip
+    //! @arg nonZeroWinding: the fill rule of the shape
+    //! @arg clip: the clip region
+    //! @arg clipNonZeroWinding: the fill rule of the clip region
+    //! @arg tolerance: the flattening tolerance for curves, in the shapes' units
+    static ShapeData getIntersection(const ShapeData& shape, bool nonZeroWinding, const ShapeData& clip,
+                                     bool clipNonZeroWinding, float tolerance);
+    //! @brief returns the number of line segments a shape fills with once flattened
+    static int countEdges(const ShapeData& shape, float tolerance);
+    //! @brief rasterizes a shape and returns the number of pixels it covers, counting partial pixels fractionally
+    //! @arg area: the region of the shape's units that is rendered
+    //! @arg pixelSize: the size of the square image the area is fitted into
+    static double getCoverage(const ShapeData& shape, const Rectangle<float>& area, int pixelSize);
+    
+private:
+    struct Edge
+    {
+        Point<double> start, end;
+        int owner;
+    };
+    
+    //! @brief a shape with the fill rule that decides which points it covers
+    struct Operand
+    {
+        const ShapeData* shape;
+        bool nonZeroWinding;
+    };
+    
+    //! @arg operands: the shapes, the result covers the area where the inside function holds
+    //! @arg isInside: given whether each operand covers a point, returns whether the result does
+    static ShapeData combine(const std::vector<Operand>& operands,
+                             const std::function<bool(const std::vector<bool>&)>& isInside, float tolerance);
+    static void addEdges(const ShapeData& shape, int owner, float tolerance, std::vector<Edge>& edges);
+    static std::vector<Edge> splitEdges(const std::vector<Edge>& edges, double snap);
+    static ShapeData chainEdges(const std::vector<Edge>& edges, double snap);
+};
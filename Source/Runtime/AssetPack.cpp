@@ -0,0 +1,200 @@
+#include "AssetPack.h"
+#include "NameHash.h"
+#include "../ShapeData.h"
+
+AssetPack::AssetPack(const File& file)
+{
+    mappedFile = std::make_unique<MemoryMappedFile>(file, MemoryMappedFile::readOnly);
+    
+    if (mappedFile->getData() != nullptr)
+        open(mappedFile->getData(), mappedFile->getSize());
+}
+
+AssetPack::AssetPack(const void* data, size_t size)
+{
+    open(data, size);
+}
+
+void AssetPack::open(const void* data, size_t size)
+{
+    bytes = static_cast<const uint8*>(data);
+    totalSize = size;
+    
+    if (bytes == nullptr || totalSize < headerSize || read32(0) != magic
+        || (read32(4) & 0xffff) != version || (read32(4) >> 16) != headerSize)
+        return;
+    
+    if (read64(16) != totalSize || checksum(bytes, 52) != read32(52))
+        return;
+    
+    const uint32 entries = read32(8);
+    indexOffset = read64(24);
+    stringsOffset = read64(32);
+    const uint64 dataOffset = read64(40);
+    
+    // Offsets are checked against the size before anything is added to them, so a corrupt one
+    // can't wrap around to a value that passes
+    if (indexOffset < headerSize || indexOffset > totalSize
+        || indexOffset + (uint64) entries * indexEntrySize != stringsOffset
+        || stringsOffset > dataOffset || dataOffset > totalSize)
+        return;
+    
+    // The index and names are covered by one checksum, the shape data is checked per entry
+    if (checksum(bytes + indexOffset, (size_t) (dataOffset - indexOffset)) != read32(48))
+        return;
+    
+    for (uint32 i = 0; i < entries; ++i)
+    {
+        const size_t entry = (size_t) indexOffset + i * indexEntrySize;
+        const uint64 dataStart = read64(entry + 16);
+        const uint64 dataSize = (uint64) read32(entry + 24) * sizeof(float) + read32(entry + 12);
+        
+        if (stringsOffset + read32(entry + 4) + read32(entry + 8) > dataOffset
+            || dataStart < dataOffset || dataStart > totalSize || dataSize > totalSize - dataStart
+            || dataStart % alignment != 0)
+            return;
+    }
+    
+    numEntries = entries;
+    verified.reset(new std::atomic<bool>[numEntries]());
+    valid = true;
+}
+
+uint32 AssetPack::read32(size_t offset) const
+{
+    return ByteOrder::littleEndianInt(bytes + offset);
+}
+
+uint64 AssetPack::read64(size_t offset) const
+{
+    return ByteOrder::littleEndianInt64(bytes + offset);
+}
+
+uint32 AssetPack::checksum(const void* data, size_t size)
+{
+    static const auto table = []
+    {
+        std::array<uint32, 256> t;
+        
+        for (uint32 i = 0; i < 256; ++i)
+        {
+            uint32 c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        
+        return t;
+    }();
+    
+    uint32 crc = 0xffffffffu;
+    const auto* p = static_cast<const uint8*>(data);
+    
+    for (size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    
+    return crc ^ 0xffffffffu;
+}
+
+int AssetPack::indexOf(StringRef name) const
+{
+    const char* utf8 = name.text.getAddress();
+    const size_t length = std::strlen(utf8);
+    const uint32 hash = NameHash::compute(utf8, length);
+    
+    // Binary search for the first entry with this hash, then compare names across any collisions
+    int lo = 0, hi = (int) numEntries;
+    while (lo < hi)
+    {
+        const int mid = (lo + hi) / 2;
+        if (read32(getIndexOffset(mid)) < hash)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    
+    for (int i = lo; i < (int) numEntries && read32(getIndexOffset(i)) == hash; ++i)
+    {
+        const size_t entry = getIndexOffset(i);
+        if (read32(entry + 8) == length
+            && std::memcmp(bytes + stringsOffset + read32(entry + 4), utf8, length) == 0)
+            return i;
+    }
+    
+    return -1;
+}
+
+String AssetPack::getName(int index) const
+{
+    if (!isPositiveAndBelow(index, (int) numEntries))
+        return {};
+    
+    const size_t entry = getIndexOffset(index);
+    return String::fromUTF8(reinterpret_cast<const char*>(bytes + stringsOffset + read32(entry + 4)),
+                            (int) read32(entry + 8));
+}
+
+bool AssetPack::checkEntry(int index) const
+{
+    if (verified[(size_t) index].load(std::memory_order_acquire))
+        return true;
+    
+    const size_t entry = getIndexOffset(index);
+    const size_t dataSize = read32(entry + 24) * sizeof(float) + read32(entry + 12);
+    
+    if (checksum(bytes + read64(entry + 16), dataSize) != read32(entry + 28))
+        return false;
+    
+    verified[(size_t) index].store(true, std::memory_order_release);
+    return true;
+}
+
+bool AssetPack::getPath(int index, Path& path) const
+{
+    if (!isPositiveAndBelow(index, (int) numEntries) || !checkEntry(index))
+        return false;
+    
+    const size_t entry = getIndexOffset(index);
+    const uint8* data = bytes + read64(entry + 16);
+    const uint32 numVerbs = read32(entry + 12);
+    const uint32 numCoords = read32(entry + 24);
+    const uint8* verbs = data + numCoords * sizeof(float);
+    
+    if (ShapeData::countCoords(verbs, numVerbs) != numCoords)
+        return false;
+
+#if JUCE_LITTLE_ENDIAN
+    // Mapped files are page aligned and entries 16 byte aligned, so the floats are used in place
+    if (reinterpret_cast<pointer_sized_int>(data) % alignof(float) == 0)
+    {
+        ShapeData::appendTo(path, verbs, numVerbs, reinterpret_cast<const float*>(data));
+        return true;
+    }
+#endif
+
+    HeapBlock<float> coords(numCoords);
+    for (uint32 i = 0; i < numCoords; ++i)
+    {
+        const uint32 bits = ByteOrder::littleEndianInt(data + i * sizeof(float));
+        std::memcpy(coords + i, &bits, sizeof(float));
+    }
+    
+    ShapeData::appendTo(path, verbs, numVerbs, coords);
+    return true;
+}
+
+Path AssetPack::getPath(StringRef name) const
+{
+    Path path;
+    getPath(indexOf(name), path);
+    return path;
+}
+
+bool AssetPack::verify() const
+{
+    for (int i = 0; i < (int) numEntries; ++i)
+        if (!checkEntry(i))
+            return false;
+    
+    return valid;
+}
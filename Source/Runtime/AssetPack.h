@@ -0,0 +1,67 @@
+#pragma once
+
+#include "RuntimeIncludes.h"
+
+//! @brief a versioned, checksummed file of converted shapes that is read through a memory map
+//! The file is little-endian and every section starts on a 16 byte boundary:
+//!   header (64 bytes): magic 'S2PK', version (uint16), headerSize (uint16), numEntries, flags,
+//!                      fileSize, indexOffset, stringsOffset, dataOffset (all uint64),
+//!                      indexChecksum (index and strings), headerChecksum (bytes 0-51), reserved
+//!   index:   numEntries x 32 byte { nameHash, nameOffset, nameLength, numVerbs,
+//!                                   dataOffset (uint64), numCoords, dataChecksum }, sorted by hash
+//!   strings: utf-8 names
+//!   data:    per entry, numCoords floats followed by numVerbs ShapeData verbs
+//! Opening a pack maps it and checks the header and index, so the cost does not grow with the
+//! size of the shape data. Each entry's checksum is checked when it is first decoded.
+class AssetPack
+{
+public:
+    static constexpr uint32 magic = 0x4b503253; // "S2PK"
+    static constexpr uint16 version = 1;
+    static constexpr size_t headerSize = 64;
+    static constexpr size_t indexEntrySize = 32;
+    static constexpr size_t alignment = 16;
+    
+    //! @brief maps a pack file
+    explicit AssetPack(const File& file);
+    //! @brief reads a pack that is already in memory, the data must outlive the object
+    AssetPack(const void* data, size_t size);
+    
+    //! @brief returns false if the file could not be mapped or failed its header or index checks
+    bool isValid() const { return valid; }
+    int getNumEntries() const { return (int) numEntries; }
+    
+    //! @brief returns the index of the named entry, or -1 if the pack does not contain it
+    int indexOf(StringRef name) const;
+    String getName(int index) const;
+    
+    //! @brief checks an entry's checksum and appends its shape to a path
+    //! @return false if the index is out of range or the data is corrupt
+    bool getPath(int index, Path& path) const;
+    //! @brief decodes an entry by name, returns an empty path if it is missing or corrupt
+    Path getPath(StringRef name) const;
+    
+    //! @brief checks the data checksum of every entry, which reads the whole file
+    bool verify() const;
+    
+    //! @brief the CRC-32 used for the header, index and data checksums
+    static uint32 checksum(const void* data, size_t size);
+    
+private:
+    void open(const void* data, size_t size);
+    uint32 read32(size_t offset) const;
+    uint64 read64(size_t offset) const;
+    size_t getIndexOffset(int index) const { return (size_t) indexOffset + (size_t) index * indexEntrySize; }
+    bool checkEntry(int index) const;
+    
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    const uint8* bytes{nullptr};
+    size_t totalSize{0};
+    uint32 numEntries{0};
+    uint64 indexOffset{0};
+    uint64 stringsOffset{0};
+    std::unique_ptr<std::atomic<bool>[]> verified;
+    bool valid{false};
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AssetPack)
+};
@@ -0,0 +1,107 @@
+#include "IconBundle.h"
+#include "NameHash.h"
+
+IconBundle::IconBundle(const void* data, size_t size) : bytes(static_cast<const uint8*>(data)), totalSize(size)
+{
+    if (bytes == nullptr || totalSize < headerSize || read(0) != magic || (read(4) & 0xffff) != version)
+        return;
+    
+    const uint32 icons = read(8);
+    const uint32 slots = read(12);
+    
+    // The slot count is a power of two larger than the icon count, so probing always ends
+    if (slots == 0 || (slots & (slots - 1)) != 0 || slots <= icons)
+        return;
+    
+    const uint64 tablesEnd = headerSize + (uint64) slots * 4 + (uint64) icons * entrySize;
+    if (tablesEnd > totalSize)
+        return;
+    
+    numSlots = slots;
+    
+    // Lookups read the entry a slot names without checking it again
+    for (uint32 slot = 0; slot < slots; ++slot)
+        if (read(headerSize + slot * 4) > icons)
+            return;
+    
+    for (uint32 i = 0; i < icons; ++i)
+    {
+        const size_t entry = getEntryOffset((int) i);
+        if ((uint64) read(entry + 4) + read(entry + 8) > totalSize
+            || (uint64) read(entry + 12) + read(entry + 16) > totalSize)
+            return;
+    }
+    
+    numIcons = icons;
+    valid = true;
+}
+
+uint32 IconBundle::read(size_t offset) const
+{
+    return ByteOrder::littleEndianInt(bytes + offset);
+}
+
+int IconBundle::indexOf(StringRef name) const
+{
+    if (numIcons == 0)
+        return -1;
+    
+    const char* utf8 = name.text.getAddress();
+    const size_t length = std::strlen(utf8);
+    const uint32 hash = NameHash::compute(utf8, length);
+    const uint32 mask = numSlots - 1;
+    
+    for (uint32 probe = 0, slot = hash & mask; probe < numSlots; ++probe, slot = (slot + 1) & mask)
+    {
+        const uint32 value = read(headerSize + slot * 4);
+        
+        if (value == 0)
+            return -1;
+        
+        const int index = (int) value - 1;
+        const size_t entry = getEntryOffset(index);
+        
+        if (read(entry) == hash && read(entry + 8) == length
+            && std::memcmp(bytes + read(entry + 4), utf8, length) == 0)
+            return index;
+    }
+    
+    return -1;
+}
+
+String IconBundle::getName(int index) const
+{
+    if (!isPositiveAndBelow(index, (int) numIcons))
+        return {};
+    
+    const size_t entry = getEntryOffset(index);
+    return String::fromUTF8(reinterpret_cast<const char*>(bytes + read(entry + 4)), (int) read(entry + 8));
+}
+
+bool IconBundle::getIconData(int index, const void*& data, size_t& size) const
+{
+    if (!isPositiveAndBelow(index, (int) numIcons))
+        return false;
+    
+    const size_t entry = getEntryOffset(index);
+    data = bytes + read(entry + 12);
+    size = read(entry + 16);
+    return true;
+}
+
+Path IconBundle::getPath(int index) const
+{
+    Path path;
+    const void* data;
+    size_t size;
+    
+    if (getIconData(index, data, size))
+        path.loadPathFromData(data, size);
+    
+    return path;
+}
+
+Path IconBundle::getPath(StringRef name) const
+{
+    return getPath(indexOf(name));
+}
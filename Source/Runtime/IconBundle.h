@@ -0,0 +1,54 @@
+#pragma once
+
+#include "RuntimeIncludes.h"
+
+//! @brief reads icons out of a bundle written by IconBundleWriter, without copying the data
+//! The bundle is laid out as (all integers little-endian uint32 unless noted):
+//!   header:   magic 'S2PB', version (uint16), reserved (uint16), numIcons, numSlots
+//!   slots:    numSlots open-addressed hash slots holding entry index + 1, 0 when empty
+//!   entries:  numIcons x { nameHash, nameOffset, nameLength, dataOffset, dataLength }, sorted by name
+//!   names:    utf-8 icon names
+//!   payloads: one Path::writePathToStream block per icon
+//! Looking an icon up hashes its name and probes the slot table, so finding one icon never
+//! touches the others, and only the requested payload is decoded.
+class IconBundle
+{
+public:
+    static constexpr uint32 magic = 0x42503253; // "S2PB"
+    static constexpr uint16 version = 1;
+    static constexpr size_t headerSize = 16;
+    static constexpr size_t entrySize = 20;
+    
+    //! @brief wraps a bundle, the data must stay valid for the lifetime of the object
+    //! @arg data: the bundle, e.g. a compiled-in array
+    //! @arg size: the size of the bundle in bytes
+    IconBundle(const void* data, size_t size);
+    
+    //! @brief returns false if the data is not a bundle this reader understands
+    bool isValid() const { return valid; }
+    int getNumIcons() const { return (int) numIcons; }
+    
+    //! @brief returns the index of the named icon, or -1 if the bundle does not contain it
+    int indexOf(StringRef name) const;
+    //! @brief returns the name of the icon at an index, in sorted order
+    String getName(int index) const;
+    //! @brief returns the serialised path of an icon, as accepted by Path::loadPathFromData
+    bool getIconData(int index, const void*& data, size_t& size) const;
+    
+    //! @brief decodes one icon, returns an empty path if the index is out of range
+    Path getPath(int index) const;
+    //! @brief decodes one icon by name, returns an empty path if the bundle does not contain it
+    Path getPath(StringRef name) const;
+    
+private:
+    uint32 read(size_t offset) const;
+    size_t getEntryOffset(int index) const { return headerSize + numSlots * 4 + (size_t) index * entrySize; }
+    
+    const uint8* bytes{nullptr};
+    size_t totalSize{0};
+    uint32 numIcons{0};
+    uint32 numSlots{0};
+    bool valid{false};
+    
+    JUCE_LEAK_DETECTOR(IconBundle)
+};
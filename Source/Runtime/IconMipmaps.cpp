@@ -0,0 +1,145 @@
+#include "IconMipmaps.h"
+
+IconMipmaps::IconMipmaps(const void* data, size_t size, const Path& path)
+    : bytes(static_cast<const uint8*>(data)), totalSize(size), fallbackPath(path)
+{
+    if (bytes == nullptr || totalSize < headerSize || read32(0) != magic || read16(4) != version)
+        return;
+    
+    const uint32 mips = read16(6);
+    
+    if (headerSize + (size_t) mips * mipEntrySize > totalSize)
+        return;
+    
+    for (uint32 i = 0; i < mips; ++i)
+    {
+        const size_t entry = headerSize + i * mipEntrySize;
+        
+        if (read16(entry) == 0 || (uint64) read32(entry + 4) + read32(entry + 8) > (uint64) totalSize)
+            return;
+    }
+    
+    numMips = mips;
+    decoded.resize(numMips);
+    valid = true;
+}
+
+uint32 IconMipmaps::read32(size_t offset) const
+{
+    return ByteOrder::littleEndianInt(bytes + offset);
+}
+
+uint16 IconMipmaps::read16(size_t offset) const
+{
+    return ByteOrder::littleEndianShort(bytes + offset);
+}
+
+int IconMipmaps::getPixelSize(int index) const
+{
+    return isPositiveAndBelow(index, (int) numMips) ? (int) read16(headerSize + (size_t) index * mipEntrySize) : 0;
+}
+
+int IconMipmaps::findMip(int pixelSize) const
+{
+    for (int i = 0; i < (int) numMips; ++i)
+        if (getPixelSize(i) == pixelSize)
+            return i;
+    
+    return -1;
+}
+
+bool IconMipmaps::decodeMask(const uint8* source, size_t sourceSize, uint8* dest, size_t destSize)
+{
+    size_t in = 0, out = 0;
+    
+    while (in < sourceSize)
+    {
+        const uint8 header = source[in++];
+        
+        if (header < 128)
+        {
+            // A literal run of header + 1 bytes
+            const size_t count = (size_t) header + 1;
+            if (in + count > sourceSize || out + count > destSize)
+                return false;
+            
+            std::memcpy(dest + out, source + in, count);
+            in += count;
+            out += count;
+        }
+        else if (header > 128)
+        {
+            // One byte repeated 257 - header times
+            const size_t count = 257 - (size_t) header;
+            if (in >= sourceSize || out + count > destSize)
+                return false;
+            
+            std::memset(dest + out, source[in++], count);
+            out += count;
+        }
+    }
+    
+    return out == destSize;
+}
+
+Image IconMipmaps::getMip(int index) const
+{
+    if (!isPositiveAndBelow(index, (int) numMips))
+        return {};
+    
+    const ScopedLock sl(decodeLock);
+    auto& mip = decoded[(size_t) index];
+    
+    if (mip.isNull())
+    {
+        const size_t entry = headerSize + (size_t) index * mipEntrySize;
+        const int size = read16(entry);
+        
+        // A PackBits byte pair repeats at most 128 bytes, so a size the data can't fill is corrupt
+        // and nothing is allocated for it
+        if ((uint64) size * (uint64) size > (uint64) read32(entry + 8) * 64)
+            return {};
+        
+        Image image(Image::SingleChannel, size, size, false, SoftwareImageType());
+        Image::BitmapData bitmap(image, Image::BitmapData::writeOnly);
+        
+        // Rows are decoded one at a time, as the bitmap's line stride may be padded
+        HeapBlock<uint8> pixels((size_t) (size * size));
+        if (!decodeMask(bytes + read32(entry + 4), read32(entry + 8), pixels, (size_t) (size * size)))
+            return {};
+        
+        for (int y = 0; y < size; ++y)
+        {
+            auto* line = bitmap.getLinePointer(y);
+            for (int x = 0; x < size; ++x)
+                line[x * bitmap.pixelStride] = pixels[y * size + x];
+        }
+        
+        mip = image;
+    }
+    
+    return mip;
+}
+
+void IconMipmaps::draw(Graphics& g, Rectangle<float> area, Colour colour) const
+{
+    const float side = jmin(area.getWidth(), area.getHeight());
+    const auto square = Rectangle<float>(side, side).withCentre(area.getCentre());
+    const float pixelSize = side * g.getInternalContext().getPhysicalPixelScaleFactor();
+    
+    g.setColour(colour);
+    
+    // The nearest whole pixel size, so areas off by a rounding error still use their mip
+    const int index = findMip(roundToInt(pixelSize));
+    if (index >= 0)
+    {
+        auto mip = getMip(index);
+        if (mip.isValid())
+        {
+            g.drawImage(mip, square, RectanglePlacement::stretchToFit, true);
+            return;
+        }
+    }
+    
+    g.fillPath(fallbackPath, AffineTransform::scale(side).translated(square.getX(), square.getY()));
+}
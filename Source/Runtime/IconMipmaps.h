@@ -0,0 +1,65 @@
+#pragma once
+
+#include "RuntimeIncludes.h"
+
+//! @brief draws an icon from alpha masks baked by IconMipmapWriter, falling back to its path
+//! The data is laid out as (all integers little-endian):
+//!   header:  magic 'S2PM' (uint32), version (uint16), numMips (uint16)
+//!   mips:    numMips x { pixelSize (uint16), reserved (uint16), dataOffset, dataLength (uint32) },
+//!            sorted by pixel size
+//!   masks:   one square 8 bit alpha mask per mip, PackBits run-length encoded row by row
+//! An alpha mask is premultiplied by definition, so tinting is a single multiply per pixel. Masks
+//! are decoded the first time they are drawn.
+class IconMipmaps
+{
+public:
+    static constexpr uint32 magic = 0x4d503253; // "S2PM"
+    static constexpr uint16 version = 1;
+    static constexpr size_t headerSize = 8;
+    static constexpr size_t mipEntrySize = 12;
+    
+    //! @brief wraps baked masks, the data must stay valid for the lifetime of the object
+    //! @arg data: the masks, e.g. a compiled-in array
+    //! @arg size: the size of the data in bytes
+    //! @arg fallbackPath: the icon normalised to a unit square, drawn at sizes that were not baked
+    IconMipmaps(const void* data, size_t size, const Path& fallbackPath = {});
+    
+    //! @brief returns false if the data is not a set of masks this reader understands
+    bool isValid() const { return valid; }
+    int getNumMips() const { return (int) numMips; }
+    //! @brief returns the width and height of a mip in physical pixels
+    int getPixelSize(int index) const;
+    //! @brief returns the mip baked at a physical pixel size, or -1 if there is none
+    int findMip(int pixelSize) const;
+    //! @brief returns a mip as a single channel image, decoding it on first use
+    Image getMip(int index) const;
+    
+    void setFallbackPath(const Path& path) { fallbackPath = path; }
+    
+    //! @brief draws the icon centred in an area, tinted with a colour
+    //! Uses the mip that matches the area's physical size, which is a straight blit when the
+    //! area sits on pixel boundaries, and fills the fallback path at any other size.
+    //! @arg g: the graphics context, whose scale factor picks the mip
+    //! @arg area: the logical area to draw the icon in
+    //! @arg colour: the tint
+    void draw(Graphics& g, Rectangle<float> area, Colour colour) const;
+    
+    //! @brief decodes one PackBits stream
+    //! @return false if the stream is malformed or does not fill the output exactly
+    static bool decodeMask(const uint8* source, size_t sourceSize, uint8* dest, size_t destSize);
+    
+private:
+    uint32 read32(size_t offset) const;
+    uint16 read16(size_t offset) const;
+    
+    const uint8* bytes{nullptr};
+    size_t totalSize{0};
+    uint32 numMips{0};
+    bool valid{false};
+    Path fallbackPath;
+    
+    CriticalSection decodeLock;
+    mutable std::vector<Image> decoded;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IconMipmaps)
+};
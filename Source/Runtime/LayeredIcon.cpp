@@ -0,0 +1,77 @@
+#include "LayeredIcon.h"
+#include "../ShapeData.h"
+
+LayeredIcon::LayeredIcon(const void* data, size_t size)
+{
+    valid = false;
+    const auto* bytes = static_cast<const uint8*>(data);
+    
+    if (bytes == nullptr || size < headerSize || ByteOrder::littleEndianInt(bytes) != magic
+        || ByteOrder::littleEndianShort(bytes + 4) != version)
+        return;
+    
+    const int numLayers = ByteOrder::littleEndianShort(bytes + 6);
+    size_t offset = headerSize;
+    std::vector<float> coords;
+    
+    for (int i = 0; i < numLayers; ++i)
+    {
+        if (offset + layerHeaderSize > size)
+            return;
+        
+        const auto colour = Colour(ByteOrder::littleEndianInt(bytes + offset));
+        const auto flags = ByteOrder::littleEndianShort(bytes + offset + 4);
+        const size_t numVerbs = ByteOrder::littleEndianInt(bytes + offset + 8);
+        const size_t numCoords = ByteOrder::littleEndianInt(bytes + offset + 12);
+        offset += layerHeaderSize;
+        
+        const size_t coordsSize = numCoords * sizeof(float);
+        const size_t verbsSize = (numVerbs + 3) & ~(size_t) 3;
+        
+        if (numVerbs > size || numCoords > size || offset + coordsSize + verbsSize > size)
+            return;
+        
+        const auto* verbs = bytes + offset + coordsSize;
+        if (ShapeData::countCoords(verbs, numVerbs) != numCoords)
+            return;
+        
+        coords.resize(numCoords);
+        for (size_t c = 0; c < numCoords; ++c)
+        {
+            const uint32 bits = ByteOrder::littleEndianInt(bytes + offset + c * sizeof(float));
+            std::memcpy(&coords[c], &bits, sizeof(float));
+        }
+        
+        Path path;
+        path.setUsingNonZeroWinding((flags & evenOddFill) == 0);
+        ShapeData::appendTo(path, verbs, numVerbs, coords.data());
+        addLayer(path, colour);
+        
+        offset += coordsSize + verbsSize;
+    }
+    
+    valid = true;
+}
+
+void LayeredIcon::addLayer(const Path& path, Colour colour)
+{
+    bounds = layers.empty() ? path.getBounds() : bounds.getUnion(path.getBounds());
+    layers.push_back({path, colour});
+}
+
+void LayeredIcon::draw(Graphics& g, const AffineTransform& transform, float opacity) const
+{
+    for (const auto& layer: layers)
+    {
+        g.setColour(layer.colour.withMultipliedAlpha(opacity));
+        g.fillPath(layer.path, transform);
+    }
+}
+
+void LayeredIcon::drawWithin(Graphics& g, Rectangle<float> area, RectanglePlacement placement, float opacity) const
+{
+    if (bounds.isEmpty() || area.isEmpty())
+        return;
+    
+    draw(g, placement.getTransformToFit(bounds, area), opacity);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "RuntimeIncludes.h"
+
+//! @brief a multi-colour icon drawn as a stack of filled paths, one per paint
+//! Layers come from code generated by SvgParser or from a table written by LayeredIconWriter,
+//! laid out as (all integers little-endian):
+//!   header:  magic 'S2PL' (uint32), version (uint16), numLayers (uint16)
+//!   layers:  numLayers x { colour (ARGB uint32), flags (uint16), reserved (uint16), numVerbs,
+//!            numCoords (uint32), numCoords floats, numVerbs ShapeData verbs padded to 4 bytes }
+//! Layers are decoded into paths once when the table is read, drawing only sets a colour and
+//! fills each path, so there is no xml to parse and no component tree to build.
+class LayeredIcon
+{
+public:
+    static constexpr uint32 magic = 0x4c503253; // "S2PL"
+    static constexpr uint16 version = 1;
+    static constexpr size_t headerSize = 8;
+    static constexpr size_t layerHeaderSize = 16;
+    
+    //! @brief the flags stored with each layer
+    enum LayerFlags
+    {
+        evenOddFill = 1 // the path is filled with the even-odd rule instead of non-zero
+    };
+    
+    struct Layer
+    {
+        Path path;
+        Colour colour;
+    };
+    
+    //! @brief creates an empty icon, for generated code to add its layers to
+    LayeredIcon() {};
+    //! @brief decodes a table of layers, the data is not needed afterwards
+    //! @arg data: the table, e.g. a compiled-in array
+    //! @arg size: the size of the data in bytes
+    LayeredIcon(const void* data, size_t size);
+    
+    //! @brief returns false if the data is not a table this reader understands
+    bool isValid() const { return valid; }
+    int getNumLayers() const { return (int) layers.size(); }
+    const Layer& getLayer(int index) const { return layers[(size_t) index]; }
+    //! @brief returns the area covered by all layers, in the units they were generated in
+    Rectangle<float> getBounds() const { return bounds; }
+    
+    //! @brief adds a layer on top of the others
+    void addLayer(const Path& path, Colour colour);
+    
+    //! @brief fills every layer in order
+    //! @arg transform: maps the layers' units onto the graphics context
+    //! @arg opacity: multiplies the alpha of every layer
+    void draw(Graphics& g, const AffineTransform& transform = {}, float opacity = 1.0f) const;
+    //! @brief fits the icon's bounds into an area and draws it there
+    void drawWithin(Graphics& g, Rectangle<float> area, RectanglePlacement placement = RectanglePlacement::centred,
+                    float opacity = 1.0f) const;
+                    
+private:
+    std::vector<Layer> layers;
+    Rectangle<float> bounds;
+    bool valid{true};
+    
+    JUCE_LEAK_DETECTOR(LayeredIcon)
+};
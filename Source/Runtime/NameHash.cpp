@@ -0,0 +1,14 @@
+#include "NameHash.h"
+
+uint32 NameHash::compute(const char* utf8, size_t numBytes)
+{
+    uint32 hash = 2166136261u;
+    
+    for (size_t i = 0; i < numBytes; ++i)
+    {
+        hash ^= (uint8) utf8[i];
+        hash *= 16777619u;
+    }
+    
+    return hash;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "RuntimeIncludes.h"
+
+//! @brief the FNV-1a hash that IconBundle and AssetPack index names by
+//! It is part of both file formats, so the readers and the writers hash names with this one
+//! function.
+struct NameHash
+{
+    //! @arg utf8: the name, not necessarily null terminated
+    //! @arg numBytes: the length of the name in bytes
+    static uint32 compute(const char* utf8, size_t numBytes);
+};
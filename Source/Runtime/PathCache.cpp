@@ -0,0 +1,199 @@
+#include "PathCache.h"
+#include "AssetPack.h"
+#include "IconBundle.h"
+
+PathCache::PathCache(size_t budget, int numShards) : memoryBudget(budget)
+{
+    size_t count = 1;
+    while (count < (size_t) jmax(1, numShards))
+        count <<= 1;
+    
+    shards = std::vector<Shard>(count);
+}
+
+uint64 PathCache::hashKey(const void* source, StringRef name)
+{
+    // FNV-1a over the source address and the name, the high bits pick the shard
+    uint64 hash = 14695981039346656037ull;
+    auto mix = [&hash](uint8 byte) {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    };
+    
+    const auto address = (uint64) reinterpret_cast<pointer_sized_int>(source);
+    for (int i = 0; i < 8; ++i)
+        mix((uint8) (address >> (i * 8)));
+    
+    for (const char* c = name.text.getAddress(); *c != 0; ++c)
+        mix((uint8) *c);
+    
+    return hash;
+}
+
+std::shared_ptr<const Path> PathCache::getPath(const void* source, StringRef name,
+                                               const std::function<bool(Path&)>& decode)
+{
+    const uint64 hash = hashKey(source, name);
+    auto& shard = getShard(hash);
+    
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        auto it = shard.index.find(hash);
+        
+        if (it != shard.index.end() && it->second->source == source && it->second->name == name)
+        {
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second->path;
+        }
+    }
+    
+    misses.fetch_add(1, std::memory_order_relaxed);
+    
+    // Decode without holding the lock, so a slow decode does not stall other lookups in the shard
+    auto path = std::make_shared<Path>();
+    if (!decode(*path))
+        return nullptr;
+    
+    const size_t size = getSizeInBytes(*path);
+    
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto it = shard.index.find(hash);
+    
+    if (it != shard.index.end())
+    {
+        // Another thread decoded the same path first, so hand out the shared copy
+        if (it->second->source == source && it->second->name == name)
+        {
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return it->second->path;
+        }
+        
+        // Two keys with the same hash, the newer one replaces the older
+        shard.size -= it->second->size;
+        shard.entries.erase(it->second);
+        shard.index.erase(it);
+    }
+    
+    shard.entries.push_front({hash, source, name, path, size});
+    shard.index[hash] = shard.entries.begin();
+    shard.size += size;
+    
+    evict(shard, memoryBudget.load(std::memory_order_relaxed) / shards.size());
+    
+    return path;
+}
+
+std::shared_ptr<const Path> PathCache::getPath(const void* pathData, size_t numBytes)
+{
+    return getPath(pathData, {}, [=](Path& path) {
+        path.loadPathFromData(pathData, numBytes);
+        return true;
+    });
+}
+
+std::shared_ptr<const Path> PathCache::getPath(const AssetPack& pack, StringRef name)
+{
+    return getPath(&pack, name, [&](Path& path) {
+        return pack.getPath(pack.indexOf(name), path);
+    });
+}
+
+std::shared_ptr<const Path> PathCache::getPath(const IconBundle& bundle, StringRef name)
+{
+    return getPath(&bundle, name, [&](Path& path) {
+        const int index = bundle.indexOf(name);
+        if (index < 0)
+            return false;
+        
+        path = bundle.getPath(index);
+        return true;
+    });
+}
+
+void PathCache::evict(Shard& shard, size_t budget)
+{
+    // The most recent entry is always kept, even if it is larger than the shard's budget on its own
+    while (shard.size > budget && shard.entries.size() > 1)
+    {
+        auto& last = shard.entries.back();
+        shard.size -= last.size;
+        shard.index.erase(last.hash);
+        shard.entries.pop_back();
+        evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void PathCache::setMemoryBudget(size_t newBudget)
+{
+    memoryBudget = newBudget;
+    
+    for (auto& shard: shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        evict(shard, newBudget / shards.size());
+    }
+}
+
+void PathCache::clear()
+{
+    for (auto& shard: shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.entries.clear();
+        shard.index.clear();
+        shard.size = 0;
+    }
+}
+
+PathCache::Statistics PathCache::getStatistics() const
+{
+    Statistics stats;
+    stats.hits = hits.load(std::memory_order_relaxed);
+    stats.misses = misses.load(std::memory_order_relaxed);
+    stats.evictions = evictions.load(std::memory_order_relaxed);
+    
+    for (auto& shard: shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        stats.numEntries += shard.entries.size();
+        stats.sizeInBytes += shard.size;
+    }
+    
+    return stats;
+}
+
+void PathCache::resetStatistics()
+{
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+}
+
+size_t PathCache::getSizeInBytes(const Path& path)
+{
+    // Path stores a marker float per element followed by its points
+    size_t numFloats = 0;
+    
+    for (Path::Iterator it(path); it.next();)
+    {
+        switch (it.elementType)
+        {
+            case Path::Iterator::startNewSubPath:
+            case Path::Iterator::lineTo:
+                numFloats += 3;
+                break;
+            case Path::Iterator::quadraticTo:
+                numFloats += 5;
+                break;
+            case Path::Iterator::cubicTo:
+                numFloats += 7;
+                break;
+            case Path::Iterator::closePath:
+                numFloats += 1;
+                break;
+        }
+    }
+    
+    return sizeof(Path) + numFloats * sizeof(float);
+}
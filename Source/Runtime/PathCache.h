@@ -0,0 +1,86 @@
+#pragma once
+
+#include "RuntimeIncludes.h"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+class AssetPack;
+class IconBundle;
+
+//! @brief decodes converted paths once and shares them between callers
+//! Entries are spread over independently locked shards by key hash, so threads painting
+//! different icons rarely wait on each other. Each shard evicts its least recently used
+//! paths when it goes over its share of the memory budget. Decoding happens outside the
+//! lock, and evicted paths stay valid for as long as a caller holds on to them.
+class PathCache
+{
+public:
+    //! @brief hit and eviction counts, for sizing the cache
+    struct Statistics
+    {
+        uint64 hits{0};
+        uint64 misses{0};
+        uint64 evictions{0};
+        size_t numEntries{0};
+        size_t sizeInBytes{0};
+        
+        double getHitRate() const { return hits + misses > 0 ? (double) hits / (double) (hits + misses) : 0.0; }
+    };
+    
+    //! @arg memoryBudget: the approximate number of bytes of decoded paths to keep
+    //! @arg numShards: the number of independently locked shards, rounded up to a power of two
+    explicit PathCache(size_t memoryBudget = 4 * 1024 * 1024, int numShards = 16);
+    
+    //! @brief returns the path for data written by SvgParser::getBinary, keyed by its address
+    std::shared_ptr<const Path> getPath(const void* pathData, size_t numBytes);
+    //! @brief returns an asset from a pack, or nullptr if the pack does not contain it
+    std::shared_ptr<const Path> getPath(const AssetPack& pack, StringRef name);
+    //! @brief returns an icon from a bundle, or nullptr if the bundle does not contain it
+    std::shared_ptr<const Path> getPath(const IconBundle& bundle, StringRef name);
+    //! @brief returns a cached path, decoding it on a miss
+    //! @arg source: identifies where the path comes from, together with the name
+    //! @arg name: the name of the path within its source
+    //! @arg decode: fills in the path, returns false if it could not be decoded
+    std::shared_ptr<const Path> getPath(const void* source, StringRef name,
+                                        const std::function<bool(Path&)>& decode);
+    
+    //! @brief changes the budget, evicting paths straight away if it shrinks
+    void setMemoryBudget(size_t newBudget);
+    size_t getMemoryBudget() const { return memoryBudget; }
+    
+    void clear();
+    Statistics getStatistics() const;
+    void resetStatistics();
+    
+    //! @brief estimates the memory a path's points use, as counted against the budget
+    static size_t getSizeInBytes(const Path& path);
+    
+private:
+    struct Entry
+    {
+        uint64 hash;
+        const void* source;
+        String name;
+        std::shared_ptr<const Path> path;
+        size_t size;
+    };
+    
+    struct Shard
+    {
+        mutable std::mutex lock;
+        std::list<Entry> entries; // most recently used first
+        std::unordered_map<uint64, std::list<Entry>::iterator> index;
+        size_t size{0};
+    };
+    
+    static uint64 hashKey(const void* source, StringRef name);
+    Shard& getShard(uint64 hash) { return shards[(size_t) (hash >> 32) & (shards.size() - 1)]; }
+    void evict(Shard& shard, size_t budget);
+    
+    std::vector<Shard> shards;
+    std::atomic<size_t> memoryBudget;
+    std::atomic<uint64> hits{0}, misses{0}, evictions{0};
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PathCache)
+};
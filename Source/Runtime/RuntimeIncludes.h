@@ -0,0 +1,7 @@
+#pragma once
+
+// The runtime classes are built as a library without a generated JuceHeader.h, so they
+// include the modules they use directly and share the app's JUCE build
+#include <juce_graphics/juce_graphics.h>
+
+using namespace juce;
@@ -0,0 +1,94 @@
+#include "SignedDistanceField.h"
+
+SignedDistanceField::SignedDistanceField(const void* data, size_t dataSize)
+{
+    const auto* bytes = static_cast<const uint8*>(data);
+    
+    if (bytes == nullptr || dataSize < headerSize || ByteOrder::littleEndianInt(bytes) != magic
+        || ByteOrder::littleEndianShort(bytes + 4) != version)
+        return;
+    
+    size = ByteOrder::littleEndianShort(bytes + 6);
+    
+    auto readFloat = [bytes](size_t offset) {
+        const uint32 bits = ByteOrder::littleEndianInt(bytes + offset);
+        float value;
+        std::memcpy(&value, &bits, sizeof(float));
+        return value;
+    };
+    
+    padding = readFloat(8);
+    spread = readFloat(12);
+    
+    if (size < 2 || headerSize + (size_t) (size * size) > dataSize || !(spread > 0.0f)
+        || !(padding >= 0.0f) || padding * 2.0f >= (float) size)
+        return;
+    
+    texels = bytes + headerSize;
+    valid = true;
+}
+
+float SignedDistanceField::getDistance(float x, float y) const
+{
+    if (!valid)
+        return 0.0f;
+    
+    // Texel centres sit at half integer positions
+    const float scale = (float) size - 2.0f * padding;
+    const float tx = jlimit(0.0f, (float) (size - 1), x * scale + padding - 0.5f);
+    const float ty = jlimit(0.0f, (float) (size - 1), y * scale + padding - 0.5f);
+    
+    const int x0 = jmin((int) tx, size - 2);
+    const int y0 = jmin((int) ty, size - 2);
+    const int x1 = x0 + 1;
+    const int y1 = y0 + 1;
+    const float fx = tx - (float) x0;
+    const float fy = ty - (float) y0;
+    
+    auto texel = [this](int col, int row) { return (float) texels[row * size + col]; };
+    
+    const float top = texel(x0, y0) + (texel(x1, y0) - texel(x0, y0)) * fx;
+    const float bottom = texel(x0, y1) + (texel(x1, y1) - texel(x0, y1)) * fx;
+    const float value = top + (bottom - top) * fy;
+    
+    // 128 is the outline and 255 - 128 steps cover spread texels
+    return (value - 128.0f) / 127.0f * spread / scale;
+}
+
+Image SignedDistanceField::render(int pixelSize) const
+{
+    Image image(Image::SingleChannel, pixelSize, pixelSize, true, SoftwareImageType());
+    
+    if (!valid || pixelSize <= 0)
+        return image;
+    
+    Image::BitmapData bitmap(image, Image::BitmapData::writeOnly);
+    const float step = 1.0f / (float) pixelSize;
+    
+    for (int y = 0; y < pixelSize; ++y)
+    {
+        auto* line = bitmap.getLinePointer(y);
+        
+        for (int x = 0; x < pixelSize; ++x)
+        {
+            const float distance = getDistance(((float) x + 0.5f) * step, ((float) y + 0.5f) * step);
+            const float coverage = jlimit(0.0f, 1.0f, distance * (float) pixelSize + 0.5f);
+            line[x * bitmap.pixelStride] = (uint8) roundToInt(coverage * 255.0f);
+        }
+    }
+    
+    return image;
+}
+
+void SignedDistanceField::draw(Graphics& g, Rectangle<float> area, Colour colour) const
+{
+    const float side = jmin(area.getWidth(), area.getHeight());
+    const auto square = Rectangle<float>(side, side).withCentre(area.getCentre());
+    const int pixelSize = roundToInt(side * g.getInternalContext().getPhysicalPixelScaleFactor());
+    
+    if (pixelSize <= 0)
+        return;
+    
+    g.setColour(colour);
+    g.drawImage(render(pixelSize), square, RectanglePlacement::stretchToFit, true);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "RuntimeIncludes.h"
+
+//! @brief a signed distance field of an icon written by SdfGenerator, with a CPU renderer
+//! The data is laid out as (all integers little-endian):
+//!   header:  magic 'S2PD' (uint32), version (uint16), size (uint16), padding, spread (float32)
+//!   texels:  size x size bytes, row by row
+//! The icon's unit square maps onto the texture inset by padding texels on each side. A texel
+//! of 128 lies on the outline, higher values are inside, and 0 or 255 mean at least spread
+//! texels away from it. The CPU renderer is the reference a shader implementation should match.
+class SignedDistanceField
+{
+public:
+    static constexpr uint32 magic = 0x44503253; // "S2PD"
+    static constexpr uint16 version = 1;
+    static constexpr size_t headerSize = 16;
+    
+    //! @brief wraps a field, the data must stay valid for the lifetime of the object
+    //! @arg data: the field, e.g. a compiled-in array
+    //! @arg size: the size of the data in bytes
+    SignedDistanceField(const void* data, size_t size);
+    
+    //! @brief returns false if the data is not a field this reader understands
+    bool isValid() const { return valid; }
+    //! @brief returns the width and height of the texture
+    int getSize() const { return size; }
+    //! @brief returns the margin around the unit square, in texels
+    float getPadding() const { return padding; }
+    //! @brief returns the largest distance the texels can represent, in texels
+    float getSpread() const { return spread; }
+    //! @brief returns the texels, for uploading as a texture
+    const uint8* getTexels() const { return texels; }
+    
+    //! @brief bilinearly samples the signed distance to the outline, positive inside
+    //! @arg x, y: a position in the icon's unit square
+    //! @return the distance in units of the unit square
+    float getDistance(float x, float y) const;
+    
+    //! @brief renders the field into a square single channel image
+    //! Each pixel's coverage is its distance to the outline in pixels plus a half, clamped to
+    //! [0, 1], which antialiases the edge over one pixel at any size.
+    Image render(int pixelSize) const;
+    
+    //! @brief renders at the area's physical size and draws it tinted with a colour
+    void draw(Graphics& g, Rectangle<float> area, Colour colour) const;
+    
+private:
+    const uint8* texels{nullptr};
+    int size{0};
+    float padding{0.0f};
+    float spread{0.0f};
+    bool valid{false};
+    
+    JUCE_LEAK_DETECTOR(SignedDistanceField)
+};
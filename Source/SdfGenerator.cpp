@@ -0,0 +1,356 @@
+#include "SdfGenerator.h"
+#include "IconMipmapWriter.h"
+
+SdfGenerator::SdfGenerator(int size, float spreadInTexels)
+    : textureSize(jlimit(2, 4096, size)), spread(jmax(0.5f, spreadInTexels)), padding(spread)
+{
+    // The padding keeps the outside gradient of shapes that touch the edges of the unit square
+    jassert(padding * 2.0f < (float) textureSize);
+    padding = jmin(padding, (float) (textureSize - 1) / 2.0f);
+}
+
+int SdfGenerator::solveCubic(double a, double b, double c, double d, double* roots)
+{
+    if (std::abs(a) < 1e-12)
+    {
+        if (std::abs(b) < 1e-12)
+        {
+            if (std::abs(c) < 1e-12)
+                return 0;
+            
+            roots[0] = -d / c;
+            return 1;
+        }
+        
+        const double discriminant = c * c - 4.0 * b * d;
+        if (discriminant < 0.0)
+            return 0;
+        
+        const double root = std::sqrt(discriminant);
+        roots[0] = (-c + root) / (2.0 * b);
+        roots[1] = (-c - root) / (2.0 * b);
+        return 2;
+    }
+    
+    // Normalise and solve the depressed cubic, with the trigonometric form for three real roots
+    const double A = b / a, B = c / a, C = d / a;
+    const double Q = (A * A - 3.0 * B) / 9.0;
+    const double R = (2.0 * A * A * A - 9.0 * A * B + 27.0 * C) / 54.0;
+    
+    if (R * R < Q * Q * Q)
+    {
+        const double theta = std::acos(jlimit(-1.0, 1.0, R / std::sqrt(Q * Q * Q)));
+        const double m = -2.0 * std::sqrt(Q);
+        roots[0] = m * std::cos(theta / 3.0) - A / 3.0;
+        roots[1] = m * std::cos((theta + MathConstants<double>::twoPi) / 3.0) - A / 3.0;
+        roots[2] = m * std::cos((theta - MathConstants<double>::twoPi) / 3.0) - A / 3.0;
+        return 3;
+    }
+    
+    const double U = (R > 0.0 ? -1.0 : 1.0) * std::cbrt(std::abs(R) + std::sqrt(R * R - Q * Q * Q));
+    const double V = U == 0.0 ? 0.0 : Q / U;
+    roots[0] = U + V - A / 3.0;
+    return 1;
+}
+
+float SdfGenerator::getDistanceToLine(Point<float> a, Point<float> b, Point<float> p)
+{
+    const auto ab = b - a;
+    const float lengthSquared = ab.getDotProduct(ab);
+    
+    if (lengthSquared <= 0.0f)
+        return p.getDistanceFrom(a);
+    
+    const float t = jlimit(0.0f, 1.0f, (p - a).getDotProduct(ab) / lengthSquared);
+    return p.getDistanceFrom(a + ab * t);
+}
+
+float SdfGenerator::getDistanceToQuadratic(Point<float> p0, Point<float> p1, Point<float> p2, Point<float> p)
+{
+    // With B(t) = p0 + 2ta + t^2 b, the closest point is a root of (B(t) - p).B'(t), a cubic in t
+    const auto a = p1 - p0;
+    const auto b = p2 - p1 * 2.0f + p0;
+    const auto d = p0 - p;
+    
+    double roots[3];
+    const int numRoots = solveCubic(b.getDotProduct(b), 3.0 * a.getDotProduct(b),
+                                    2.0 * a.getDotProduct(a) + d.getDotProduct(b), d.getDotProduct(a), roots);
+    
+    float distance = jmin(p.getDistanceFrom(p0), p.getDistanceFrom(p2));
+    
+    for (int i = 0; i < numRoots; ++i)
+    {
+        if (roots[i] > 0.0 && roots[i] < 1.0)
+        {
+            const auto t = (float) roots[i];
+            distance = jmin(distance, p.getDistanceFrom(p0 + a * (2.0f * t) + b * (t * t)));
+        }
+    }
+    
+    return distance;
+}
+
+float SdfGenerator::getDistanceToCubic(const Point<float>* points, Point<float> p)
+{
+    // Branch and bound over halves of the curve. A piece lies inside its control points' hull, so
+    // the hull's bounds give the closest it can come, and pieces that can't beat the best distance
+    // so far are dropped. Once no control point is more than maxCubicDistanceError from the chord,
+    // the piece's distance is within that of the chord's, so the result is too.
+    constexpr int maxDepth = 24;
+    
+    struct Piece
+    {
+        Point<float> points[4];
+        int depth;
+    };
+    
+    // Each level pushes two pieces and pops one, so the stack never holds more than maxDepth + 1
+    Piece stack[maxDepth + 1];
+    int numPieces = 0;
+    stack[numPieces++] = {{points[0], points[1], points[2], points[3]}, 0};
+    
+    float distance = jmin(p.getDistanceFrom(points[0]), p.getDistanceFrom(points[3]));
+    
+    while (numPieces > 0)
+    {
+        const auto piece = stack[--numPieces];
+        const auto* q = piece.points;
+        
+        const auto bounds = Rectangle<float>::findAreaContainingPoints(q, 4);
+        if (bounds.getConstrainedPoint(p).getDistanceFrom(p) >= distance)
+            continue;
+        
+        const float flatness = jmax(getDistanceToLine(q[0], q[3], q[1]), getDistanceToLine(q[0], q[3], q[2]));
+        if (flatness <= maxCubicDistanceError || piece.depth == maxDepth)
+        {
+            distance = jmin(distance, getDistanceToLine(q[0], q[3], p));
+            continue;
+        }
+        
+        // Split at the middle with de Casteljau's construction
+        const auto q01 = (q[0] + q[1]) * 0.5f, q12 = (q[1] + q[2]) * 0.5f, q23 = (q[2] + q[3]) * 0.5f;
+        const auto q012 = (q01 + q12) * 0.5f, q123 = (q12 + q23) * 0.5f;
+        const auto middle = (q012 + q123) * 0.5f;
+        
+        distance = jmin(distance, p.getDistanceFrom(middle));
+        
+        const Piece first{{q[0], q01, q012, middle}, piece.depth + 1};
+        const Piece second{{middle, q123, q23, q[3]}, piece.depth + 1};
+        
+        // The half nearer p goes on top, so it lowers the distance before the other is bounded
+        const bool firstIsNearer = p.getDistanceFrom(q[0]) < p.getDistanceFrom(q[3]);
+        stack[numPieces++] = firstIsNearer ? second : first;
+        stack[numPieces++] = firstIsNearer ? first : second;
+    }
+    
+    return distance;
+}
+
+float SdfGenerator::getDistance(const Segment& segment, Point<float> p)
+{
+    switch (segment.type)
+    {
+        case Path::Iterator::quadraticTo:
+            return getDistanceToQuadratic(segment.points[0], segment.points[1], segment.points[2], p);
+        case Path::Iterator::cubicTo:
+            return getDistanceToCubic(segment.points, p);
+        default:
+            return getDistanceToLine(segment.points[0], segment.points[1], p);
+    }
+}
+
+std::vector<SdfGenerator::Segment> SdfGenerator::getSegments(const Path& path, const AffineTransform& toTexels) const
+{
+    Path texelPath(path);
+    texelPath.applyTransform(toTexels);
+    
+    std::vector<Segment> segments;
+    Point<float> start, current;
+    
+    auto add = [&](Path::Iterator::PathElementType type, std::initializer_list<Point<float>> points) {
+        Segment segment{type, {}, {}};
+        int numPoints = 0;
+        for (auto point: points)
+            segment.points[numPoints++] = point;
+        
+        segment.bounds = Rectangle<float>::findAreaContainingPoints(segment.points, numPoints);
+        segments.push_back(segment);
+        current = segment.points[numPoints - 1];
+    };
+    
+    // Filling closes open sub-paths, so their outline includes the closing line
+    auto closeSubPath = [&]() {
+        if (current != start)
+            add(Path::Iterator::lineTo, {current, start});
+    };
+    
+    for (Path::Iterator it(texelPath); it.next();)
+    {
+        switch (it.elementType)
+        {
+            case Path::Iterator::startNewSubPath:
+                closeSubPath();
+                start = current = {it.x1, it.y1};
+                break;
+            case Path::Iterator::lineTo:
+                add(it.elementType, {current, {it.x1, it.y1}});
+                break;
+            case Path::Iterator::quadraticTo:
+                add(it.elementType, {current, {it.x1, it.y1}, {it.x2, it.y2}});
+                break;
+            case Path::Iterator::cubicTo:
+                add(it.elementType, {current, {it.x1, it.y1}, {it.x2, it.y2}, {it.x3, it.y3}});
+                break;
+            case Path::Iterator::closePath:
+                closeSubPath();
+                break;
+        }
+    }
+    
+    closeSubPath();
+    return segments;
+}
+
+std::vector<bool> SdfGenerator::getInsideTexels(const Path& path, const AffineTransform& toTexels, int size)
+{
+    // Scan each row of texel centres against the flattened path, with the path's winding rule
+    struct Crossing
+    {
+        float x;
+        int direction;
+    };
+    
+    std::vector<std::vector<Crossing>> rows((size_t) size);
+    
+    for (PathFlatteningIterator it(path, toTexels, 0.05f); it.next();)
+    {
+        if (it.y1 == it.y2)
+            continue;
+        
+        const float top = jmin(it.y1, it.y2);
+        const float bottom = jmax(it.y1, it.y2);
+        const int firstRow = jmax(0, (int) std::ceil(top - 0.5f));
+        const int lastRow = jmin(size - 1, (int) std::ceil(bottom - 0.5f) - 1);
+        
+        for (int row = firstRow; row <= lastRow; ++row)
+        {
+            const float y = (float) row + 0.5f;
+            const float x = it.x1 + (y - it.y1) * (it.x2 - it.x1) / (it.y2 - it.y1);
+            rows[(size_t) row].push_back({x, it.y2 > it.y1 ? 1 : -1});
+        }
+    }
+    
+    const bool nonZero = path.isUsingNonZeroWinding();
+    std::vector<bool> inside((size_t) (size * size), false);
+    
+    for (int row = 0; row < size; ++row)
+    {
+        auto& crossings = rows[(size_t) row];
+        std::sort(crossings.begin(), crossings.end(), [](const Crossing& a, const Crossing& b) { return a.x < b.x; });
+        
+        int winding = 0;
+        size_t next = 0;
+        
+        for (int col = 0; col < size; ++col)
+        {
+            while (next < crossings.size() && crossings[next].x < (float) col + 0.5f)
+                winding += crossings[next++].direction;
+            
+            inside[(size_t) (row * size + col)] = nonZero ? winding != 0 : (winding & 1) != 0;
+        }
+    }
+    
+    return inside;
+}
+
+MemoryBlock SdfGenerator::build(const Path& path) const
+{
+    const float scale = (float) textureSize - 2.0f * padding;
+    const auto toTexels = AffineTransform::scale(scale).translated(padding, padding);
+    
+    const auto segments = getSegments(path, toTexels);
+    const auto inside = getInsideTexels(path, toTexels, textureSize);
+    
+    // Bin the segments into cells one spread wide, a segment goes into every cell within spread
+    // of its control points' bounds, so a texel only measures the segments listed in its cell
+    const float cellSize = spread;
+    const int numCells = (int) std::ceil((float) textureSize / cellSize);
+    std::vector<std::vector<int>> cells((size_t) (numCells * numCells));
+    
+    for (int i = 0; i < (int) segments.size(); ++i)
+    {
+        const auto area = segments[(size_t) i].bounds.expanded(spread);
+        const int x0 = jlimit(0, numCells - 1, (int) std::floor(area.getX() / cellSize));
+        const int y0 = jlimit(0, numCells - 1, (int) std::floor(area.getY() / cellSize));
+        const int x1 = jlimit(0, numCells - 1, (int) std::floor(area.getRight() / cellSize));
+        const int y1 = jlimit(0, numCells - 1, (int) std::floor(area.getBottom() / cellSize));
+        
+        for (int y = y0; y <= y1; ++y)
+            for (int x = x0; x <= x1; ++x)
+                cells[(size_t) (y * numCells + x)].push_back(i);
+    }
+    
+    MemoryOutputStream out;
+    out.writeInt((int) SignedDistanceField::magic);
+    out.writeShort((short) SignedDistanceField::version);
+    out.writeShort((short) textureSize);
+    out.writeFloat(padding);
+    out.writeFloat(spread);
+    
+    for (int y = 0; y < textureSize; ++y)
+    {
+        for (int x = 0; x < textureSize; ++x)
+        {
+            const Point<float> centre((float) x + 0.5f, (float) y + 0.5f);
+            const auto& cell = cells[(size_t) (jmin(numCells - 1, (int) (centre.y / cellSize)) * numCells
+                                               + jmin(numCells - 1, (int) (centre.x / cellSize)))];
+            
+            float distance = spread;
+            for (auto index: cell)
+                distance = jmin(distance, getDistance(segments[(size_t) index], centre));
+            
+            if (!inside[(size_t) (y * textureSize + x)])
+                distance = -distance;
+            
+            out.writeByte((char) roundToInt(jlimit(0.0f, 255.0f, 128.0f + distance / spread * 127.0f)));
+        }
+    }
+    
+    return out.getMemoryBlock();
+}
+
+String SdfGenerator::getBinary(const Path& path, const String& name) const
+{
+    MemoryOutputStream out;
+    out << "static const unsigned char " << (name.isNotEmpty() ? name : String("icon")) << "Sdf[] = ";
+    build_tools::writeDataAsCppLiteral(build(path), out, false, true);
+    out << newLine;
+    
+    return out.toString();
+}
+
+SdfGenerator::Comparison SdfGenerator::compare(const Path& path, const MemoryBlock& field, int pixelSize)
+{
+    const SignedDistanceField sdf(field.getData(), field.getSize());
+    const auto fromField = sdf.render(pixelSize);
+    const auto fromPath = IconMipmapWriter::rasterise(path, pixelSize);
+    
+    const Image::BitmapData a(fromField, Image::BitmapData::readOnly);
+    const Image::BitmapData b(fromPath, Image::BitmapData::readOnly);
+    
+    Comparison result{pixelSize, 0.0f, 0.0f};
+    double total = 0.0;
+    
+    for (int y = 0; y < pixelSize; ++y)
+    {
+        for (int x = 0; x < pixelSize; ++x)
+        {
+            const float error = std::abs((float) a.getPixelPointer(x, y)[0] - (float) b.getPixelPointer(x, y)[0]) / 255.0f;
+            result.maxError = jmax(result.maxError, error);
+            total += error;
+        }
+    }
+    
+    result.meanError = pixelSize > 0 ? (float) (total / (pixelSize * pixelSize)) : 0.0f;
+    return result;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreIncludes.h"
+#include "Runtime/SignedDistanceField.h"
+
+//! @brief generates signed distance fields from path geometry, for SignedDistanceField to draw
+//! Distances are measured to the curves themselves rather than a flattened copy: exactly for
+//! lines and quadratics, and to within maxCubicDistanceError for cubics. Segments are
+//! binned into a grid of cells one spread wide, so each texel only measures the segments that
+//! can be within range of it.
+class SdfGenerator
+{
+public:
+    //! @brief compares a field's render with the vector render of the same path
+    struct Comparison
+    {
+        int pixelSize;
+        float maxError;     // largest coverage difference of any pixel, 0 to 1
+        float meanError;    // mean coverage difference over all pixels
+    };
+    
+    //! @arg textureSize: the width and height of the field in texels
+    //! @arg spread: the largest distance the field represents, in texels
+    SdfGenerator(int textureSize = 64, float spread = 4.0f);
+    ~SdfGenerator() {};
+    
+    //! @brief generates the field of a path
+    //! @arg path: the icon normalised to a unit square
+    MemoryBlock build(const Path& path) const;
+    //! @brief returns the field as a c++ array
+    //! @arg path: the icon normalised to a unit square
+    //! @arg name: an optional name for the exported array
+    String getBinary(const Path& path, const String& name) const;
+    
+    //! @brief renders a field with the CPU reference renderer and the path with the software
+    //! renderer, and measures how far the two differ
+    static Comparison compare(const Path& path, const MemoryBlock& field, int pixelSize);
+    
+    //! @brief the most a cubic's distance can be off, in texels, below half the step of a field
+    //! byte at the smallest spread
+    static constexpr float maxCubicDistanceError = 1.0f / 512.0f;
+    
+    //! @brief measures the distance from p to a cubic bezier, to within maxCubicDistanceError
+    //! @arg points: the start, the two control points and the end
+    static float getDistanceToCubic(const Point<float>* points, Point<float> p);
+    
+private:
+    struct Segment
+    {
+        Path::Iterator::PathElementType type;
+        Point<float> points[4];
+        Rectangle<float> bounds;
+    };
+    
+    std::vector<Segment> getSegments(const Path& path, const AffineTransform& toTexels) const;
+    static std::vector<bool> getInsideTexels(const Path& path, const AffineTransform& toTexels, int size);
+    static float getDistance(const Segment& segment, Point<float> p);
+    static float getDistanceToLine(Point<float> a, Point<float> b, Point<float> p);
+    static float getDistanceToQuadratic(Point<float> p0, Point<float> p1, Point<float> p2, Point<float> p);
+    static int solveCubic(double a, double b, double c, double d, double* roots);
+    
+    int textureSize;
+    float spread;
+    float padding;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SdfGenerator)
+};
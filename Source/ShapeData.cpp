@@ -0,0 +1,715 @@
+#include "ShapeData.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define SVG2PATH_USE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+ #include <arm_neon.h>
+ #define SVG2PATH_USE_NEON 1
+#endif
+
+int ShapeData::getNumCoords(uint8 verb)
+{
+    switch (verb)
+    {
+        case subPath:
+        case line:
+            return 2;
+        case quadratic:
+        case rectangle:
+        case ellipse:
+            return 4;
+        case cubic:
+        case roundedRectangle:
+            return 6;
+        default:
+            return 0;
+    }
+}
+
+void ShapeData::add(uint8 verb, std::initializer_list<float> values)
+{
+    verbs.push_back(verb);
+    coords.insert(coords.end(), values);
+}
+
+void ShapeData::startNewSubPath(float x, float y)
+{
+    add(subPath, {x, y});
+}
+
+void ShapeData::lineTo(float x, float y)
+{
+    add(line, {x, y});
+}
+
+void ShapeData::quadraticTo(float cx, float cy, float x, float y)
+{
+    add(quadratic, {cx, cy, x, y});
+}
+
+void ShapeData::cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y)
+{
+    add(cubic, {c1x, c1y, c2x, c2y, x, y});
+}
+
+void ShapeData::closeSubPath()
+{
+    add(close, {});
+}
+
+void ShapeData::addRectangle(float x, float y, float width, float height)
+{
+    add(rectangle, {x, y, x + width, y + height});
+}
+
+void ShapeData::addRoundedRectangle(float x, float y, float width, float height, float rx, float ry)
+{
+    add(roundedRectangle, {x, y, x + width, y + height, x + rx, y + ry});
+}
+
+void ShapeData::addEllipse(float x, float y, float width, float height)
+{
+    add(ellipse, {x, y, x + width, y + height});
+}
+
+void ShapeData::clear()
+{
+    verbs.clear();
+    coords.clear();
+}
+
+void ShapeData::append(const ShapeData& other)
+{
+    verbs.insert(verbs.end(), other.verbs.begin(), other.verbs.end());
+    coords.insert(coords.end(), other.coords.begin(), other.coords.end());
+}
+
+size_t ShapeData::countCoords(const uint8* verbs, size_t numVerbs)
+{
+    size_t numCoords = 0;
+    
+    for (size_t i = 0; i < numVerbs; ++i)
+    {
+        if (verbs[i] > ellipse)
+            return std::numeric_limits<size_t>::max();
+        
+        numCoords += (size_t) getNumCoords(verbs[i]);
+    }
+    
+    return numCoords;
+}
+
+void ShapeData::applyTransform(const AffineTransform& transform)
+{
+    if (transform.isIdentity())
+        return;
+    
+    if (transform.mat01 != 0.0f || transform.mat10 != 0.0f)
+        expandPrimitives();
+    
+    transformCoords(coords.data(), coords.size(), transform);
+}
+
+void ShapeData::transformCoords(float* xy, size_t numFloats, const AffineTransform& t)
+{
+    size_t i = 0;
+    
+    // Each vector holds two points as x0 y0 x1 y1. Multiplying it by (a, e, a, e) and the
+    // pair-swapped y0 x0 y1 x1 by (b, d, b, d) gives both rows of the matrix at once.
+#if SVG2PATH_USE_SSE2
+    const __m128 m0 = _mm_setr_ps(t.mat00, t.mat11, t.mat00, t.mat11);
+    const __m128 m1 = _mm_setr_ps(t.mat01, t.mat10, t.mat01, t.mat10);
+    const __m128 m2 = _mm_setr_ps(t.mat02, t.mat12, t.mat02, t.mat12);
+    
+    for (; i + 8 <= numFloats; i += 8)
+    {
+        __m128 p0 = _mm_loadu_ps(xy + i);
+        __m128 p1 = _mm_loadu_ps(xy + i + 4);
+        __m128 s0 = _mm_shuffle_ps(p0, p0, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 s1 = _mm_shuffle_ps(p1, p1, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_ps(xy + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(p0, m0), _mm_mul_ps(s0, m1)), m2));
+        _mm_storeu_ps(xy + i + 4, _mm_add_ps(_mm_add_ps(_mm_mul_ps(p1, m0), _mm_mul_ps(s1, m1)), m2));
+    }
+#elif SVG2PATH_USE_NEON
+    const float r0[] = {t.mat00, t.mat11, t.mat00, t.mat11};
+    const float r1[] = {t.mat01, t.mat10, t.mat01, t.mat10};
+    const float r2[] = {t.mat02, t.mat12, t.mat02, t.mat12};
+    const float32x4_t m0 = vld1q_f32(r0);
+    const float32x4_t m1 = vld1q_f32(r1);
+    const float32x4_t m2 = vld1q_f32(r2);
+    
+    for (; i + 8 <= numFloats; i += 8)
+    {
+        float32x4_t p0 = vld1q_f32(xy + i);
+        float32x4_t p1 = vld1q_f32(xy + i + 4);
+        vst1q_f32(xy + i, vmlaq_f32(vmlaq_f32(m2, p0, m0), vrev64q_f32(p0), m1));
+        vst1q_f32(xy + i + 4, vmlaq_f32(vmlaq_f32(m2, p1, m0), vrev64q_f32(p1), m1));
+    }
+#endif
+
+    for (; i + 2 <= numFloats; i += 2)
+        t.transformPoint(xy[i], xy[i + 1]);
+}
+
+void ShapeData::expandPrimitives()
+{
+    bool hasPrimitives = std::any_of(verbs.begin(), verbs.end(), [](uint8 verb) { return verb >= rectangle; });
+    
+    if (!hasPrimitives)
+        return;
+    
+    ShapeData expanded;
+    expanded.verbs.reserve(verbs.size());
+    expanded.coords.reserve(coords.size());
+    const float* c = coords.data();
+    
+    for (auto verb: verbs)
+    {
+        if (verb < rectangle)
+        {
+            expanded.add(verb, {});
+            expanded.coords.insert(expanded.coords.end(), c, c + getNumCoords(verb));
+            c += getNumCoords(verb);
+            continue;
+        }
+        
+        auto r = Rectangle<float>(Point<float>(c[0], c[1]), Point<float>(c[2], c[3]));
+        const float x1 = r.getX(), y1 = r.getY(), x2 = r.getRight(), y2 = r.getBottom();
+        
+        // These mirror Path::addRectangle, addRoundedRectangle and addEllipse
+        if (verb == rectangle)
+        {
+            expanded.startNewSubPath(x1, y2);
+            expanded.lineTo(x1, y1);
+            expanded.lineTo(x2, y1);
+            expanded.lineTo(x2, y2);
+            expanded.closeSubPath();
+        }
+        else if (verb == roundedRectangle)
+        {
+            const float csx = jmin(std::abs(c[4] - c[0]), r.getWidth() * 0.5f);
+            const float csy = jmin(std::abs(c[5] - c[1]), r.getHeight() * 0.5f);
+            const float cs45x = csx * 0.45f;
+            const float cs45y = csy * 0.45f;
+            
+            expanded.startNewSubPath(x1 + csx, y1);
+            expanded.lineTo(x2 - csx, y1);
+            expanded.cubicTo(x2 - cs45x, y1, x2, y1 + cs45y, x2, y1 + csy);
+            expanded.lineTo(x2, y2 - csy);
+            expanded.cubicTo(x2, y2 - cs45y, x2 - cs45x, y2, x2 - csx, y2);
+            expanded.lineTo(x1 + csx, y2);
+            expanded.cubicTo(x1 + cs45x, y2, x1, y2 - cs45y, x1, y2 - csy);
+            expanded.lineTo(x1, y1 + csy);
+            expanded.cubicTo(x1, y1 + cs45y, x1 + cs45x, y1, x1 + csx, y1);
+            expanded.closeSubPath();
+        }
+        else if (verb == ellipse)
+        {
+            const float hw = r.getWidth() * 0.5f;
+            const float hh = r.getHeight() * 0.5f;
+            const float hw55 = hw * 0.55f;
+            const float hh55 = hh * 0.55f;
+            const float cx = x1 + hw;
+            const float cy = y1 + hh;
+            
+            expanded.startNewSubPath(cx, cy - hh);
+            expanded.cubicTo(cx + hw55, cy - hh, cx + hw, cy - hh55, cx + hw, cy);
+            expanded.cubicTo(cx + hw, cy + hh55, cx + hw55, cy + hh, cx, cy + hh);
+            expanded.cubicTo(cx - hw55, cy + hh, cx - hw, cy + hh55, cx - hw, cy);
+            expanded.cubicTo(cx - hw, cy - hh55, cx - hw55, cy - hh, cx, cy - hh);
+            expanded.closeSubPath();
+        }
+        
+        c += getNumCoords(verb);
+    }
+    
+    verbs.swap(expanded.verbs);
+    coords.swap(expanded.coords);
+}
+
+void ShapeData::addPath(const Path& path)
+{
+    for (Path::Iterator it(path); it.next();)
+    {
+        switch (it.elementType)
+        {
+            case Path::Iterator::startNewSubPath:
+                startNewSubPath(it.x1, it.y1);
+                break;
+            case Path::Iterator::lineTo:
+                lineTo(it.x1, it.y1);
+                break;
+            case Path::Iterator::quadraticTo:
+                quadraticTo(it.x1, it.y1, it.x2, it.y2);
+                break;
+            case Path::Iterator::cubicTo:
+                cubicTo(it.x1, it.y1, it.x2, it.y2, it.x3, it.y3);
+                break;
+            case Path::Iterator::closePath:
+                closeSubPath();
+                break;
+        }
+    }
+}
+
+void ShapeData::reverse()
+{
+    expandPrimitives();
+    
+    ShapeData reversed;
+    reversed.verbs.reserve(verbs.size());
+    reversed.coords.reserve(coords.size());
+    
+    // The segments of the current sub-path, each starting where the one before it ends
+    std::vector<std::pair<uint8, const float*>> segments;
+    float startX = 0.0f, startY = 0.0f;
+    
+    auto flush = [&](bool closed) {
+        if (segments.empty())
+            return;
+        
+        auto endOf = [&](size_t i) {
+            const float* c = segments[i].second + getNumCoords(segments[i].first) - 2;
+            return Point<float>(c[0], c[1]);
+        };
+        
+        auto end = endOf(segments.size() - 1);
+        reversed.startNewSubPath(end.x, end.y);
+        
+        for (size_t i = segments.size(); i-- > 0;)
+        {
+            const auto to = i > 0 ? endOf(i - 1) : Point<float>(startX, startY);
+            const float* c = segments[i].second;
+            
+            if (segments[i].first == quadratic)
+                reversed.quadraticTo(c[0], c[1], to.x, to.y);
+            else if (segments[i].first == cubic)
+                reversed.cubicTo(c[2], c[3], c[0], c[1], to.x, to.y);
+            else
+                reversed.lineTo(to.x, to.y);
+        }
+        
+        if (closed)
+            reversed.closeSubPath();
+        
+        segments.clear();
+    };
+    
+    const float* c = coords.data();
+    
+    for (auto verb: verbs)
+    {
+        if (verb == subPath)
+        {
+            flush(false);
+            startX = c[0];
+            startY = c[1];
+        }
+        else if (verb == close)
+        {
+            flush(true);
+        }
+        else
+        {
+            segments.push_back({verb, c});
+        }
+        
+        c += getNumCoords(verb);
+    }
+    
+    flush(false);
+    
+    verbs = std::move(reversed.verbs);
+    coords = std::move(reversed.coords);
+}
+
+float ShapeData::getSignedArea(float tolerance) const
+{
+    Path path;
+    appendTo(path);
+    
+    // The flattening iterator closes every sub-path, as filling does
+    double area = 0.0;
+    for (PathFlatteningIterator it(path, {}, tolerance); it.next();)
+        area += (double) it.x1 * it.y2 - (double) it.x2 * it.y1;
+    
+    return (float) (area * 0.5);
+}
+
+void ShapeData::orientContours(bool nonZeroWinding, float tolerance)
+{
+    expandPrimitives();
+    
+    struct Contour
+    {
+        size_t firstVerb, numVerbs, firstCoord, numCoords;
+        std::vector<Line<double>> edges;
+        Rectangle<double> bounds;
+        double area;
+    };
+    
+    std::vector<Contour> contours;
+    size_t coord = 0;
+    
+    for (size_t i = 0; i < verbs.size(); ++i)
+    {
+        if (verbs[i] == subPath || contours.empty())
+            contours.push_back({i, 0, coord, 0, {}, {}, 0.0});
+        
+        const auto numCoords = (size_t) getNumCoords(verbs[i]);
+        ++contours.back().numVerbs;
+        contours.back().numCoords += numCoords;
+        coord += numCoords;
+    }
+    
+    // A single contour bounds the fill on its inside under either rule
+    if (contours.size() < 2)
+    {
+        if (getSignedArea(tolerance) < 0.0f)
+            reverse();
+        
+        return;
+    }
+    
+    for (auto& contour: contours)
+    {
+        Path path;
+        appendTo(path, verbs.data() + contour.firstVerb, contour.numVerbs, coords.data() + contour.firstCoord);
+        
+        for (PathFlatteningIterator it(path, {}, tolerance); it.next();)
+        {
+            contour.edges.emplace_back(it.x1, it.y1, it.x2, it.y2);
+            contour.area += 0.5 * ((double) it.x1 * it.y2 - (double) it.x2 * it.y1);
+        }
+        
+        contour.bounds = path.getBounds().toDouble();
+    }
+    
+    // The winding of every contour around a point, positive inside contours of positive area
+    auto getWinding = [&contours](Point<double> p) {
+        int winding = 0;
+        
+        for (const auto& contour: contours)
+        {
+            if (p.y < contour.bounds.getY() || p.y > contour.bounds.getBottom() || p.x > contour.bounds.getRight())
+                continue;
+            
+            for (const auto& edge: contour.edges)
+            {
+                const auto a = edge.getStart(), b = edge.getEnd();
+                if ((a.y <= p.y) == (b.y <= p.y))
+                    continue;
+                
+                if (a.x + (p.y - a.y) * (b.x - a.x) / (b.y - a.y) > p.x)
+                    winding += b.y > a.y ? 1 : -1;
+            }
+        }
+        
+        return winding;
+    };
+    
+    auto isFilled = [nonZeroWinding](int winding) { return nonZeroWinding ? winding != 0 : (winding & 1) != 0; };
+    
+    ShapeData oriented;
+    oriented.verbs.reserve(verbs.size());
+    oriented.coords.reserve(coords.size());
+    
+    for (const auto& contour: contours)
+    {
+        ShapeData part;
+        part.verbs.assign(verbs.data() + contour.firstVerb, verbs.data() + contour.firstVerb + contour.numVerbs);
+        part.coords.assign(coords.data() + contour.firstCoord, coords.data() + contour.firstCoord + contour.numCoords);
+        
+        // Step to either side of the middle of the longest edge, the one other contours are least
+        // likely to touch, and compare the fill on the contour's inside with the fill outside it
+        const auto longest = std::max_element(contour.edges.begin(), contour.edges.end(),
+                                              [](const Line<double>& a, const Line<double>& b) { return a.getLength() < b.getLength(); });
+        
+        if (longest != contour.edges.end() && longest->getLength() > 0.0 && contour.area != 0.0)
+        {
+            const double length = longest->getLength();
+            const auto direction = (longest->getEnd() - longest->getStart()) / length;
+            const auto step = Point<double>(-direction.y, direction.x) * (length * 1.0e-3 * (contour.area > 0.0 ? 1.0 : -1.0));
+            const auto middle = longest->getPointAlongLineProportionally(0.5);
+            const int inside = getWinding(middle + step);
+            const int outside = getWinding(middle - step);
+            
+            // Outlines of the fill turn positive and holes negative. A contour with the fill on both
+            // sides keeps its turn relative to the winding around it, so what it encloses stays filled.
+            const bool positive = isFilled(inside) != isFilled(outside) ? isFilled(inside)
+                                                                        : (contour.area > 0.0) == (outside >= 0);
+            
+            if (positive != (contour.area > 0.0))
+                part.reverse();
+        }
+        
+        oriented.append(part);
+    }
+    
+    verbs = std::move(oriented.verbs);
+    coords = std::move(oriented.coords);
+}
+
+void ShapeData::flatten(float tolerance)
+{
+    auto isCurvedPrimitive = [](uint8 verb) { return verb == roundedRectangle || verb == ellipse; };
+    auto isCurved = [&](uint8 verb) { return verb == quadratic || verb == cubic || isCurvedPrimitive(verb); };
+    
+    if (tolerance <= 0.0f || std::none_of(verbs.begin(), verbs.end(), isCurved))
+        return;
+    
+    // Plain rectangles have no curves, so they stay compact
+    if (std::any_of(verbs.begin(), verbs.end(), isCurvedPrimitive))
+        expandPrimitives();
+    
+    ShapeData flat;
+    flat.verbs.reserve(verbs.size());
+    flat.coords.reserve(coords.size());
+    const float* c = coords.data();
+    float x = 0.0f, y = 0.0f, startX = 0.0f, startY = 0.0f;
+    
+    for (auto verb: verbs)
+    {
+        switch (verb)
+        {
+            case subPath:
+                flat.startNewSubPath(c[0], c[1]);
+                x = startX = c[0];
+                y = startY = c[1];
+                break;
+            case line:
+                flat.lineTo(c[0], c[1]);
+                x = c[0];
+                y = c[1];
+                break;
+            case quadratic:
+            {
+                // Stepping a quadratic in n equal steps strays at most |p0 - 2p1 + p2| / 4n^2 from it
+                const float dd = std::hypot(x - 2.0f * c[0] + c[2], y - 2.0f * c[1] + c[3]);
+                const int numSteps = jmax(1, (int) std::ceil(std::sqrt(dd / (4.0f * tolerance))));
+                
+                for (int i = 1; i < numSteps; ++i)
+                {
+                    const float t = (float) i / (float) numSteps, mt = 1.0f - t;
+                    flat.lineTo(mt * mt * x + 2.0f * mt * t * c[0] + t * t * c[2],
+                                mt * mt * y + 2.0f * mt * t * c[1] + t * t * c[3]);
+                }
+                
+                flat.lineTo(c[2], c[3]);
+                x = c[2];
+                y = c[3];
+                break;
+            }
+            case cubic:
+                flat.flattenCubic(x, y, c[0], c[1], c[2], c[3], c[4], c[5], tolerance, 0);
+                x = c[4];
+                y = c[5];
+                break;
+            case close:
+                flat.closeSubPath();
+                x = startX;
+                y = startY;
+                break;
+            default:
+                flat.add(verb, {});
+                flat.coords.insert(flat.coords.end(), c, c + getNumCoords(verb));
+                break;
+        }
+        
+        c += getNumCoords(verb);
+    }
+    
+    verbs = std::move(flat.verbs);
+    coords = std::move(flat.coords);
+}
+
+void ShapeData::simplify(float tolerance)
+{
+    if (tolerance <= 0.0f || std::count(verbs.begin(), verbs.end(), (uint8) line) < 2)
+        return;
+    
+    ShapeData simple;
+    simple.verbs.reserve(verbs.size());
+    simple.coords.reserve(coords.size());
+    std::vector<Point<float>> run;
+    std::vector<bool> keep;
+    const float* c = coords.data();
+    float x = 0.0f, y = 0.0f, startX = 0.0f, startY = 0.0f;
+    
+    for (size_t i = 0; i < verbs.size();)
+    {
+        const auto verb = verbs[i];
+        
+        if (verb == line)
+        {
+            // A run of lines starts at the current point, which stays where it is
+            run.assign(1, {x, y});
+            for (; i < verbs.size() && verbs[i] == line; ++i, c += 2)
+                run.push_back({c[0], c[1]});
+            
+            getSimplifiedPoints(run, tolerance, keep);
+            for (size_t j = 1; j < run.size(); ++j)
+                if (keep[j])
+                    simple.lineTo(run[j].x, run[j].y);
+            
+            x = run.back().x;
+            y = run.back().y;
+            continue;
+        }
+        
+        switch (verb)
+        {
+            case subPath:
+                x = startX = c[0];
+                y = startY = c[1];
+                break;
+            case quadratic:
+                x = c[2];
+                y = c[3];
+                break;
+            case cubic:
+                x = c[4];
+                y = c[5];
+                break;
+            case close:
+                x = startX;
+                y = startY;
+                break;
+            default:
+                break;
+        }
+        
+        simple.add(verb, {});
+        simple.coords.insert(simple.coords.end(), c, c + getNumCoords(verb));
+        c += getNumCoords(verb);
+        ++i;
+    }
+    
+    verbs = std::move(simple.verbs);
+    coords = std::move(simple.coords);
+}
+
+void ShapeData::getSimplifiedPoints(const std::vector<Point<float>>& points, float tolerance, std::vector<bool>& keep)
+{
+    keep.assign(points.size(), false);
+    keep.front() = keep.back() = true;
+    
+    // Split at the point furthest from the chord until every point is close enough, on a stack
+    // rather than recursing, so long runs of flattened curves can't overflow it
+    std::vector<std::pair<size_t, size_t>> ranges{{0, points.size() - 1}};
+    
+    while (!ranges.empty())
+    {
+        const auto range = ranges.back();
+        ranges.pop_back();
+        
+        const Line<float> chord(points[range.first], points[range.second]);
+        float maxDistance = 0.0f;
+        size_t furthest = range.first;
+        
+        for (auto i = range.first + 1; i < range.second; ++i)
+        {
+            Point<float> nearest;
+            const float distance = chord.getDistanceFromPoint(points[i], nearest);
+            
+            if (distance > maxDistance)
+            {
+                maxDistance = distance;
+                furthest = i;
+            }
+        }
+        
+        if (maxDistance > tolerance)
+        {
+            keep[furthest] = true;
+            ranges.push_back({range.first, furthest});
+            ranges.push_back({furthest, range.second});
+        }
+    }
+}
+
+void ShapeData::quantise(float step)
+{
+    if (step <= 0.0f)
+        return;
+    
+    for (auto& coord: coords)
+        coord = std::round(coord / step) * step;
+}
+
+void ShapeData::flattenCubic(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3,
+                             float tolerance, int depth)
+{
+    // The curve stays within tolerance of its chord when max(ux^2, vx^2) + max(uy^2, vy^2) <= 16 tolerance^2
+    const float ux = 3.0f * x1 - 2.0f * x0 - x3, uy = 3.0f * y1 - 2.0f * y0 - y3;
+    const float vx = 3.0f * x2 - x0 - 2.0f * x3, vy = 3.0f * y2 - y0 - 2.0f * y3;
+    
+    if (depth >= maxFlatteningDepth
+        || jmax(ux * ux, vx * vx) + jmax(uy * uy, vy * vy) <= 16.0f * tolerance * tolerance)
+    {
+        lineTo(x3, y3);
+        return;
+    }
+    
+    // Split at t = 0.5 with de Casteljau's construction
+    const float ax = (x0 + x1) * 0.5f, ay = (y0 + y1) * 0.5f;
+    const float bx = (x1 + x2) * 0.5f, by = (y1 + y2) * 0.5f;
+    const float cx = (x2 + x3) * 0.5f, cy = (y2 + y3) * 0.5f;
+    const float abx = (ax + bx) * 0.5f, aby = (ay + by) * 0.5f;
+    const float bcx = (bx + cx) * 0.5f, bcy = (by + cy) * 0.5f;
+    const float mx = (abx + bcx) * 0.5f, my = (aby + bcy) * 0.5f;
+    
+    flattenCubic(x0, y0, ax, ay, abx, aby, mx, my, tolerance, depth + 1);
+    flattenCubic(mx, my, bcx, bcy, cx, cy, x3, y3, tolerance, depth + 1);
+}
+
+void ShapeData::appendTo(Path& path) const
+{
+    appendTo(path, verbs.data(), verbs.size(), coords.data());
+}
+
+void ShapeData::appendTo(Path& path, const uint8* verbs, size_t numVerbs, const float* c)
+{
+    for (size_t i = 0; i < numVerbs; ++i)
+    {
+        const uint8 verb = verbs[i];
+        
+        switch (verb)
+        {
+            case subPath:
+                path.startNewSubPath(c[0], c[1]);
+                break;
+            case line:
+                path.lineTo(c[0], c[1]);
+                break;
+            case quadratic:
+                path.quadraticTo(c[0], c[1], c[2], c[3]);
+                break;
+            case cubic:
+                path.cubicTo(c[0], c[1], c[2], c[3], c[4], c[5]);
+                break;
+            case close:
+                path.closeSubPath();
+                break;
+            case rectangle:
+                path.addRectangle(Rectangle<float>(Point<float>(c[0], c[1]), Point<float>(c[2], c[3])));
+                break;
+            case roundedRectangle:
+            {
+                auto r = Rectangle<float>(Point<float>(c[0], c[1]), Point<float>(c[2], c[3]));
+                path.addRoundedRectangle(r.getX(), r.getY(), r.getWidth(), r.getHeight(),
+                                         std::abs(c[4] - c[0]), std::abs(c[5] - c[1]));
+                break;
+            }
+            case ellipse:
+                path.addEllipse(Rectangle<float>(Point<float>(c[0], c[1]), Point<float>(c[2], c[3])));
+                break;
+            default:
+                jassertfalse;
+                break;
+        }
+        
+        c += getNumCoords(verb);
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Runtime/RuntimeIncludes.h"
+#include <vector>
+
+//! @brief a flat list of drawing verbs and their coordinates, as parsed from one svg element
+//! Every coordinate is stored as part of an x/y pair, so a shape can be moved or scaled
+//! by walking the coords array in one go. Rectangles and ellipses are kept as single
+//! verbs so they can be written out as compact Path::addRectangle / addEllipse calls.
+class ShapeData
+{
+public:
+    enum Verb : uint8
+    {
+        subPath,          // x, y
+        line,             // x, y
+        quadratic,        // cx, cy, x, y
+        cubic,            // c1x, c1y, c2x, c2y, x, y
+        close,            // no coords
+        rectangle,        // x1, y1, x2, y2: two opposite corners
+        roundedRectangle, // x1, y1, x2, y2, x1 + rx, y1 + ry
+        ellipse           // x1, y1, x2, y2: two opposite corners of the bounding box
+    };
+    
+    //! @brief returns the number of floats stored for a verb
+    static int getNumCoords(uint8 verb);
+    
+    void startNewSubPath(float x, float y);
+    void lineTo(float x, float y);
+    void quadraticTo(float cx, float cy, float x, float y);
+    void cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y);
+    void closeSubPath();
+    void addRectangle(float x, float y, float width, float height);
+    void addRoundedRectangle(float x, float y, float width, float height, float rx, float ry);
+    void addEllipse(float x, float y, float width, float height);
+    
+    bool isEmpty() const { return verbs.empty(); }
+    void clear();
+    //! @brief appends the verbs and coords of another shape
+    void append(const ShapeData& other);
+    //! @brief appends the elements of a juce path, e.g. one built by PathStrokeType
+    void addPath(const Path& path);
+    //! @brief reverses the direction of every sub-path, expanding primitives first
+    void reverse();
+    //! @brief returns the area of the flattened shape, positive when it turns the way
+    //! Path::addRectangle and addEllipse do
+    //! @arg tolerance: the flattening tolerance, in the shape's units
+    float getSignedArea(float tolerance) const;
+    //! @brief turns outlines of the filled area positive and holes negative, contour by contour
+    //! Which contours bound the fill is decided by the fill rule, so the shape fills the same area
+    //! under non-zero winding afterwards, and shapes appended to it add up rather than cancel out.
+    //! @arg nonZeroWinding: the fill rule the shape was drawn with
+    //! @arg tolerance: the flattening tolerance, in the shape's units
+    void orientContours(bool nonZeroWinding, float tolerance);
+    
+    //! @brief transforms all coordinates in place
+    //! Scales and translations keep rectangles and ellipses as compact verbs, any other
+    //! transform first expands them into lines and curves.
+    //! @arg transform: the transform to apply, identity transforms return immediately
+    void applyTransform(const AffineTransform& transform);
+    //! @brief transforms interleaved x/y pairs in place, using SSE2 or NEON where available
+    //! @arg xy: the coordinates to transform
+    //! @arg numFloats: the number of floats in the array, twice the number of points
+    //! @arg transform: the transform to apply
+    static void transformCoords(float* xy, size_t numFloats, const AffineTransform& transform);
+    //! @brief replaces rectangle and ellipse verbs with the lines and curves juce would add for them
+    void expandPrimitives();
+    //! @brief replaces every curve with lines that stay within a tolerance of it
+    //! Quadratics are split into the fewest equal steps that meet the tolerance, cubics are
+    //! subdivided where they bend, so flat stretches cost a single line.
+    //! @arg tolerance: the largest distance between a curve and its lines, in output units
+    void flatten(float tolerance);
+    //! @brief removes line points that lie within a tolerance of the outline without them
+    //! Each run of lines is reduced with Douglas-Peucker, curves and primitives are kept as they are.
+    //! @arg tolerance: the largest distance between a removed point and the lines that replace it
+    void simplify(float tolerance);
+    //! @brief rounds every coordinate to a multiple of a step, so the emitted numbers are shorter
+    //! @arg step: the grid size in output units, 0 keeps the coordinates
+    void quantise(float step);
+    
+    //! @brief appends the shape to a juce path
+    //! @arg path: the path to add the shape to
+    void appendTo(Path& path) const;
+    //! @brief appends verbs and coords stored elsewhere, e.g. in a mapped asset pack, to a juce path
+    //! @arg path: the path to add the shape to
+    //! @arg verbs: the verbs
+    //! @arg numVerbs: the number of verbs
+    //! @arg coords: the coords, getNumCoords() for each verb in turn
+    static void appendTo(Path& path, const uint8* verbs, size_t numVerbs, const float* coords);
+    //! @brief returns the number of coords a run of verbs uses, or the largest size_t if one of
+    //! them isn't a verb, so stored data that doesn't decode never matches its count
+    static size_t countCoords(const uint8* verbs, size_t numVerbs);
+    
+    std::vector<uint8> verbs;
+    std::vector<float> coords;
+    
+private:
+    void add(uint8 verb, std::initializer_list<float> values);
+    void flattenCubic(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3,
+                      float tolerance, int depth);
+    //! @brief marks the points of a polyline that its simplification keeps, always including both ends
+    static void getSimplifiedPoints(const std::vector<Point<float>>& points, float tolerance, std::vector<bool>& keep);
+    
+    static constexpr int maxFlatteningDepth = 10;
+    
+    JUCE_LEAK_DETECTOR(ShapeData)
+};
@@ -0,0 +1,60 @@
+#include "SvgLoader.h"
+
+SvgParser::Options SvgLoader::getParserOptions(SvgParser::OutputMode outputMode) const
+{
+    SvgParser::Options parserOptions;
+    parserOptions.normalisation = options.normalisation;
+    parserOptions.targetWidth = options.targetWidth;
+    parserOptions.targetHeight = options.targetHeight;
+    parserOptions.outputMode = outputMode;
+    parserOptions.maxArcError = options.maxArcError;
+    parserOptions.flatteningSize = options.flatteningSize;
+    parserOptions.mergeOverlaps = options.mergeOverlaps;
+    parserOptions.applyClipPaths = options.applyClipPaths;
+    parserOptions.codeGeneration = false;
+    return parserOptions;
+}
+
+Result SvgLoader::loadPath(const void* data, size_t size, Path& path) const
+{
+    auto conversion = SvgParser::convert(data, size, getParserOptions(SvgParser::OutputMode::singlePath));
+    path.swapWithPath(conversion.path);
+    
+    return conversion.wasSuccessful() ? Result::ok() : Result::fail(conversion.error);
+}
+
+Result SvgLoader::loadPath(const File& file, Path& path) const
+{
+    MemoryMappedFile mappedFile(file, MemoryMappedFile::readOnly);
+    
+    if (mappedFile.getData() == nullptr)
+        return Result::fail("Could not read " + file.getFullPathName());
+    
+    return loadPath(mappedFile.getData(), mappedFile.getSize(), path);
+}
+
+Result SvgLoader::loadIcon(const void* data, size_t size, LayeredIcon& icon) const
+{
+    auto conversion = SvgParser::convert(data, size, getParserOptions(SvgParser::OutputMode::layers));
+    
+    icon = {};
+    for (const auto& layer: conversion.layers)
+    {
+        Path path;
+        path.setUsingNonZeroWinding(layer.nonZeroWinding);
+        layer.shape.appendTo(path);
+        icon.addLayer(path, layer.colour);
+    }
+    
+    return conversion.wasSuccessful() ? Result::ok() : Result::fail(conversion.error);
+}
+
+Result SvgLoader::loadIcon(const File& file, LayeredIcon& icon) const
+{
+    MemoryMappedFile mappedFile(file, MemoryMappedFile::readOnly);
+    
+    if (mappedFile.getData() == nullptr)
+        return Result::fail("Could not read " + file.getFullPathName());
+    
+    return loadIcon(mappedFile.getData(), mappedFile.getSize(), icon);
+}
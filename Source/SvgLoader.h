@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreIncludes.h"
+#include "SvgParser.h"
+#include "Runtime/LayeredIcon.h"
+
+//! @brief loads svgs into paths or coloured layers at runtime, for artwork that can't be converted
+//! at build time such as user themes
+//! Svgs are read straight from their bytes by SvgScanner, so no xml tree is built, and no code is
+//! generated. Every load is a SvgParser::convert call, which shares nothing, so one loader can be
+//! shared by any number of threads.
+class SvgLoader
+{
+public:
+    //! @brief how loaded svgs are mapped and simplified, as set on SvgParser
+    struct Options
+    {
+        SvgParser::Normalisation normalisation{SvgParser::Normalisation::none};
+        float targetWidth{1.0f};
+        float targetHeight{1.0f};
+        float maxArcError{0.01f};
+        float flatteningSize{0.0f}; // the render size curves are flattened for, 0 keeps curves
+        bool mergeOverlaps{false};
+        bool applyClipPaths{true};
+    };
+    
+    SvgLoader() {};
+    explicit SvgLoader(const Options& loaderOptions) : options(loaderOptions) {};
+    ~SvgLoader() {};
+    
+    //! @brief loads every shape of an svg into one path
+    //! @arg data: the svg's utf-8 bytes
+    //! @arg size: the size of the data in bytes
+    //! @arg path: receives the shapes, cleared first
+    Result loadPath(const void* data, size_t size, Path& path) const;
+    //! @brief loads an svg file into one path, reading it through a memory map
+    Result loadPath(const File& file, Path& path) const;
+    
+    //! @brief loads an svg into layers of one paint each
+    //! @arg data: the svg's utf-8 bytes
+    //! @arg size: the size of the data in bytes
+    //! @arg icon: receives the layers, replacing any it had
+    Result loadIcon(const void* data, size_t size, LayeredIcon& icon) const;
+    //! @brief loads an svg file into layers of one paint each, reading it through a memory map
+    Result loadIcon(const File& file, LayeredIcon& icon) const;
+    
+private:
+    SvgParser::Options getParserOptions(SvgParser::OutputMode outputMode) const;
+    
+    Options options;
+    
+    JUCE_LEAK_DETECTOR(SvgLoader)
+};
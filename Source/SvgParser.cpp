@@ -1,6 +1,10 @@
 #include "SvgParser.h"
+#include "PathBoolean.h"
+#include "SvgScanner.h"
+#include "Tracing.h"
+#include <map>
 
-bool SvgParser::parseNumber(const String& s, int& index, float& number)
+bool SvgParser::parseNumber(const TextView& s, int& index, float& number)
 {
     while (index < s.length() && CharacterFunctions::isWhitespace(s[index]))
         ++index;
@@ -42,7 +46,37 @@ bool SvgParser::parseNumber(const String& s, int& index, float& number)
     if (start == index)
         return false;
     
-    number = s.substring(start, index).getFloatValue();
+    // Numbers are read from a copy on the stack rather than a substring, which would allocate
+    char token[64];
+    const int length = index - start;
+    
+    if (length < (int) sizeof(token))
+    {
+        memcpy(token, s.text + start, (size_t) length);
+        token[length] = 0;
+        number = (float) CharacterFunctions::getDoubleValue(CharPointer_ASCII(token));
+    }
+    else
+    {
+        number = String::fromUTF8(s.text + start, length).getFloatValue();
+    }
+    
+    while (index < s.length() && (CharacterFunctions::isWhitespace(s[index]) || s[index] == ','))
+        ++index;
+    
+    return true;
+}
+
+bool SvgParser::parseFlag(const TextView& s, int& index, bool& flag)
+{
+    while (index < s.length() && CharacterFunctions::isWhitespace(s[index]))
+        ++index;
+    
+    // arc flags are single digits and may be packed without separators, e.g. "a1 1 0 0110 10"
+    if (index >= s.length() || (s[index] != '0' && s[index] != '1'))
+        return false;
+    
+    flag = s[index++] == '1';
     
     while (index < s.length() && (CharacterFunctions::isWhitespace(s[index]) || s[index] == ','))
         ++index;
@@ -50,9 +84,114 @@ bool SvgParser::parseNumber(const String& s, int& index, float& number)
     return true;
 }
 
-String SvgParser::parseSVGPathData(const String& pathData, Path& path)
+int SvgParser::getNumArcSegments(double radius, double sweepAngle, float maxError)
+{
+    // A cubic with control length 4/3 tan(a/4) approximating a circular arc of angle a
+    // has a maximum radial error of r * 2/27 * sin^6(a/4) / cos^2(a/4). Find the smallest
+    // number of equal segments that keeps it under the bound, never letting one exceed pi.
+    const double angle = std::abs(sweepAngle);
+    const int minSegments = jmax(1, (int) std::ceil(angle / MathConstants<double>::pi - 1.0e-9));
+    
+    for (int n = minSegments; n < maxArcSegments; ++n)
+    {
+        const double quarter = angle / (4.0 * n);
+        const double s = std::sin(quarter);
+        const double c = std::cos(quarter);
+        const double error = radius * 2.0 / 27.0 * std::pow(s, 6.0) / (c * c);
+        
+        if (error <= maxError)
+            return n;
+    }
+    
+    return maxArcSegments;
+}
+
+void SvgParser::addArc(float x1, float y1, float rx, float ry, float angle, bool largeArc, bool sweep,
+                       float x2, float y2, ShapeData& shape)
+{
+    if (x1 == x2 && y1 == y2)
+        return;
+    
+    double radiusX = std::abs((double) rx);
+    double radiusY = std::abs((double) ry);
+    
+    if (radiusX == 0.0 || radiusY == 0.0)
+    {
+        shape.lineTo(x2, y2);
+        return;
+    }
+    
+    // Endpoint to centre parameterisation, as described in the SVG implementation notes (F.6.5)
+    const double phi = degreesToRadians((double) angle);
+    const double cosPhi = std::cos(phi);
+    const double sinPhi = std::sin(phi);
+    
+    const double dx = (x1 - x2) * 0.5;
+    const double dy = (y1 - y2) * 0.5;
+    const double x1p = cosPhi * dx + sinPhi * dy;
+    const double y1p = -sinPhi * dx + cosPhi * dy;
+    
+    // Scale up radii that are too small to span the endpoints
+    const double lambda = (x1p * x1p) / (radiusX * radiusX) + (y1p * y1p) / (radiusY * radiusY);
+    if (lambda > 1.0)
+    {
+        radiusX *= std::sqrt(lambda);
+        radiusY *= std::sqrt(lambda);
+    }
+    
+    const double rx2 = radiusX * radiusX;
+    const double ry2 = radiusY * radiusY;
+    const double denominator = rx2 * y1p * y1p + ry2 * x1p * x1p;
+    const double numerator = rx2 * ry2 - denominator;
+    double coef = denominator > 0.0 ? std::sqrt(jmax(0.0, numerator / denominator)) : 0.0;
+    if (largeArc == sweep)
+        coef = -coef;
+    
+    const double cxp = coef * radiusX * y1p / radiusY;
+    const double cyp = -coef * radiusY * x1p / radiusX;
+    const double cx = cosPhi * cxp - sinPhi * cyp + (x1 + x2) * 0.5;
+    const double cy = sinPhi * cxp + cosPhi * cyp + (y1 + y2) * 0.5;
+    
+    const double theta1 = std::atan2((y1p - cyp) / radiusY, (x1p - cxp) / radiusX);
+    const double theta2 = std::atan2((-y1p - cyp) / radiusY, (-x1p - cxp) / radiusX);
+    double deltaTheta = theta2 - theta1;
+    
+    if (sweep && deltaTheta < 0.0)
+        deltaTheta += MathConstants<double>::twoPi;
+    else if (!sweep && deltaTheta > 0.0)
+        deltaTheta -= MathConstants<double>::twoPi;
+    
+    const int numSegments = getNumArcSegments(jmax(radiusX, radiusY), deltaTheta, options.maxArcError);
+    const double segmentAngle = deltaTheta / numSegments;
+    const double k = 4.0 / 3.0 * std::tan(segmentAngle * 0.25);
+    
+    // Maps a point of the unit circle onto the ellipse
+    auto mapX = [&](double u, double v) { return (float) (cx + radiusX * u * cosPhi - radiusY * v * sinPhi); };
+    auto mapY = [&](double u, double v) { return (float) (cy + radiusX * u * sinPhi + radiusY * v * cosPhi); };
+    
+    double t1 = theta1;
+    for (int i = 0; i < numSegments; ++i)
+    {
+        const double t2 = (i == numSegments - 1) ? theta1 + deltaTheta : t1 + segmentAngle;
+        const double cos1 = std::cos(t1), sin1 = std::sin(t1);
+        const double cos2 = std::cos(t2), sin2 = std::sin(t2);
+        
+        float cx1 = mapX(cos1 - k * sin1, sin1 + k * cos1);
+        float cy1 = mapY(cos1 - k * sin1, sin1 + k * cos1);
+        float cx2 = mapX(cos2 + k * sin2, sin2 - k * cos2);
+        float cy2 = mapY(cos2 + k * sin2, sin2 - k * cos2);
+        float ex = (i == numSegments - 1) ? x2 : mapX(cos2, sin2);
+        float ey = (i == numSegments - 1) ? y2 : mapY(cos2, sin2);
+        
+        shape.cubicTo(cx1, cy1, cx2, cy2, ex, ey);
+        t1 = t2;
+    }
+}
+
+bool SvgParser::parseSVGPathData(const TextView& pathData, ShapeData& shape)
 {
-    String juceCode;
+    SVG2PATH_TRACE_SCOPE("parseSVGPathData");
+    
     int index = 0;
     juce_wchar command = 0;
     juce_wchar prevCommand = 0;
@@ -83,8 +222,8 @@ String SvgParser::parseSVGPathData(const String& pathData, Path& path)
         }
         else
         {
-            std::cerr << "Invalid path data at position " << index << std::endl;
-            return {};
+            warnings.add("Invalid path data at position " + String(index));
+            return false;
         }
         
         bool isRelative = CharacterFunctions::isLowerCase(command);
@@ -96,8 +235,8 @@ String SvgParser::parseSVGPathData(const String& pathData, Path& path)
                 float x1, y1;
                 if (!parseNumber(pathData, index, x1) || !parseNumber(pathData, index, y1))
                 {
-                    std::cerr << "Invalid 'M' command at position " << index << std::endl;
-                    return {};
+                    warnings.add("Invalid 'M' command at position " + String(index));
+                    return false;
                 }
                 if (isRelative)
                 {
@@ -109,8 +248,7 @@ String SvgParser::parseSVGPathData(const String& pathData, Path& path)
                     x = x1;
                     y = y1;
                 }
-                juceCode << "    path.startNewSubPath(" << f(x) << ", " << f(y) << ");\n";
-                path.startNewSubPath(x, y);
+                shape.startNewSubPath(x, y);
                 startX = x;
                 startY = y;
                 prevCommand = isRelative ? 'l' : 'L';
@@ -133,8 +271,7 @@ String SvgParser::parseSVGPathData(const String& pathData, Path& path)
                         x = x1;
                         y = y1;
                     }
-                    juceCode << "    path.lineTo(" << f(x) << ", " << f(y) << ");\n";
-                    path.lineTo(x, y);
+                    shape.lineTo(x, y);
                 }
                 prevCommand = command;
                 break;
@@ -154,8 +291,7 @@ String SvgParser::parseSVGPathData(const String& pathData, Path& path)
                     {
                         x = x1;
                     }
-                    juceCode << "    path.lineTo(" << f(x) << ", " << f(y) << ");\n";
-                    path.lineTo(x, y);
+                    shape.lineTo(x, y);
                 }
                 prevCommand = command;
                 break;
@@ -175,8 +311,7 @@ String SvgParser::parseSVGPathData(const String& pathData, Path& path)
                     {
                         y = y1;
                     }
-                    juceCode << "    path.lineTo(" << f(x) << ", " << f(y) << ");\n";
-                    path.lineTo(x, y);
+                    shape.lineTo(x, y);
                 }
                 prevCommand = command;
                 break;
@@ -196,9 +331,7 @@ String SvgParser::parseSVGPathData(const String& pathData, Path& path)
                     float cy2 = isRelative ? y + y2 : y2;
                     x = isRelative ? x + x3 : x3;
                     y = isRelative ? y + y3 : y3;
-                    juceCode << "    path.cubicTo(" << f(cx1) << ", " << f(cy1) << ", " << f(cx2) << ", " << f(cy2)
-                    << ", " << f(x) << ", " << f(y) << ");\n";
-                    path.cubicTo(cx1, cy1, cx2, cy2, x, y);
+                    shape.cubicTo(cx1, cy1, cx2, cy2, x, y);
                     prevCtrlX = cx2;
                     prevCtrlY = cy2;
                 }
@@ -219,9 +352,7 @@ String SvgParser::parseSVGPathData(const String& pathData, Path& path)
                     float cy2 = isRelative ? y + y2 : y2;
                     x = isRelative ? x + x3 : x3;
                     y = isRelative ? y + y3 : y3;
-                    juceCode << "    path.cubicTo(" << f(cx1) << ", " << f(cy1) << ", " << f(cx2) << ", " << f(cy2)
-                    << ", " << f(x) << ", " << f(y) << ");\n";
-                    path.cubicTo(cx1, cy1, cx2, cy2, x, y);
+                    shape.cubicTo(cx1, cy1, cx2, cy2, x, y);
                     prevCtrlX = cx2;
                     prevCtrlY = cy2;
                 }
@@ -240,9 +371,7 @@ String SvgParser::parseSVGPathData(const String& pathData, Path& path)
                     float cy1 = isRelative ? y + y1 : y1;
                     x = isRelative ? x + x2 : x2;
                     y = isRelative ? y + y2 : y2;
-                    juceCode << "    path.quadraticTo(" << f(cx1) << ", " << f(cy1) << ", " << f(x) << ", " << f(y)
-                    << ");\n";
-                    path.quadraticTo(cx1, cy1, x, y);
+                    shape.quadraticTo(cx1, cy1, x, y);
                     prevCtrlX = cx1;
                     prevCtrlY = cy1;
                 }
@@ -260,9 +389,7 @@ String SvgParser::parseSVGPathData(const String& pathData, Path& path)
                     float cy1 = y * 2 - prevCtrlY;
                     x = isRelative ? x + x2 : x2;
                     y = isRelative ? y + y2 : y2;
-                    juceCode << "    path.quadraticTo(" << f(cx1) << ", " << f(cy1) << ", " << f(x) << ", " << f(y)
-                    << ");\n";
-                    path.quadraticTo(cx1, cy1, x, y);
+                    shape.quadraticTo(cx1, cy1, x, y);
                     prevCtrlX = cx1;
                     prevCtrlY = cy1;
                 }
@@ -271,114 +398,1455 @@ String SvgParser::parseSVGPathData(const String& pathData, Path& path)
             }
             case 'A':
             {
-                // Arc commands are complex and require more elaborate handling.
-                // For simplicity, you can approximate arcs with cubic Bézier curves or skip them.
-                std::cerr << "Arc commands are not supported in this parser.\n";
-                return {};
+                while (true)
+                {
+                    float rx, ry, angle, x2, y2;
+                    bool largeArc, sweep;
+                    if (!parseNumber(pathData, index, rx) || !parseNumber(pathData, index, ry)
+                        || !parseNumber(pathData, index, angle) || !parseFlag(pathData, index, largeArc)
+                        || !parseFlag(pathData, index, sweep) || !parseNumber(pathData, index, x2)
+                        || !parseNumber(pathData, index, y2))
+                        break;
+                    x2 = isRelative ? x + x2 : x2;
+                    y2 = isRelative ? y + y2 : y2;
+                    addArc(x, y, rx, ry, angle, largeArc, sweep, x2, y2, shape);
+                    x = x2;
+                    y = y2;
+                    prevCtrlX = x;
+                    prevCtrlY = y;
+                }
+                prevCommand = command;
+                break;
             }
             case 'Z':
             {
-                juceCode << "    path.closeSubPath();\n";
-                path.closeSubPath();
+                shape.closeSubPath();
                 x = startX;
                 y = startY;
                 prevCommand = command;
                 break;
             }
             default:
-                std::cerr << "Unknown command '" << (char) command << "' at position " << index << std::endl;
-                return {};
+                warnings.add("Unknown command '" + String::charToString(command) + "' at position " + String(index));
+                return false;
         }
     }
     
-    return juceCode;
+    return true;
 }
 
-void SvgParser::collectPaths(XmlElement* element, std::vector<String>& pathDataList)
+bool SvgParser::parsePoints(const String& points, bool close, ShapeData& shape)
 {
-    if (element == nullptr)
-        return;
+    const TextView view(points);
+    int index = 0;
+    float x, y;
+    
+    if (!parseNumber(view, index, x) || !parseNumber(view, index, y))
+        return false;
+    
+    shape.startNewSubPath(x, y);
+    
+    while (parseNumber(view, index, x) && parseNumber(view, index, y))
+        shape.lineTo(x, y);
+    
+    if (close)
+        shape.closeSubPath();
+    
+    return true;
+}
+
+bool SvgParser::parseShape(const XmlElement& element, ShapeData& shape)
+{
+    auto number = [&](StringRef name) { return (float) element.getDoubleAttribute(name); };
+    
+    if (element.hasTagName("path"))
+    {
+        return parseSVGPathData(element.getStringAttribute("d"), shape);
+    }
+    else if (element.hasTagName("rect"))
+    {
+        float width = number("width");
+        float height = number("height");
+        
+        // A zero sized rect disables rendering of the element
+        if (width <= 0.0f || height <= 0.0f)
+            return true;
+        
+        // If only one of rx/ry is given it is used for both, each is clamped to half the size
+        float rx = element.hasAttribute("rx") ? number("rx") : number("ry");
+        float ry = element.hasAttribute("ry") ? number("ry") : rx;
+        rx = jlimit(0.0f, width * 0.5f, rx);
+        ry = jlimit(0.0f, height * 0.5f, ry);
+        
+        if (rx > 0.0f && ry > 0.0f)
+            shape.addRoundedRectangle(number("x"), number("y"), width, height, rx, ry);
+        else
+            shape.addRectangle(number("x"), number("y"), width, height);
+        
+        return true;
+    }
+    else if (element.hasTagName("circle"))
+    {
+        float r = number("r");
+        if (r > 0.0f)
+            shape.addEllipse(number("cx") - r, number("cy") - r, r * 2.0f, r * 2.0f);
+        return true;
+    }
+    else if (element.hasTagName("ellipse"))
+    {
+        float rx = number("rx");
+        float ry = number("ry");
+        if (rx > 0.0f && ry > 0.0f)
+            shape.addEllipse(number("cx") - rx, number("cy") - ry, rx * 2.0f, ry * 2.0f);
+        return true;
+    }
+    else if (element.hasTagName("line"))
+    {
+        shape.startNewSubPath(number("x1"), number("y1"));
+        shape.lineTo(number("x2"), number("y2"));
+        return true;
+    }
+    else if (element.hasTagName("polyline") || element.hasTagName("polygon"))
+    {
+        return parsePoints(element.getStringAttribute("points"), element.hasTagName("polygon"), shape);
+    }
+    
+    return false;
+}
+
+AffineTransform SvgParser::parseTransform(const String& transform)
+{
+    AffineTransform result;
+    int index = 0;
+    
+    while (index < transform.length())
+    {
+        while (index < transform.length()
+               && (CharacterFunctions::isWhitespace(transform[index]) || transform[index] == ','))
+            ++index;
+        
+        int nameStart = index;
+        while (index < transform.length() && CharacterFunctions::isLetter(transform[index]))
+            ++index;
+        
+        auto name = transform.substring(nameStart, index);
+        int open = transform.indexOfChar(index, '(');
+        int close = transform.indexOfChar(index, ')');
+        
+        if (name.isEmpty() || open < 0 || close < open)
+            break;
+        
+        const auto arguments = transform.substring(open + 1, close);
+        const TextView view(arguments);
+        float values[6] = {};
+        int numValues = 0;
+        int argIndex = 0;
+        
+        while (numValues < 6 && parseNumber(view, argIndex, values[numValues]))
+            ++numValues;
+        
+        index = close + 1;
+        AffineTransform t;
+        
+        if (name == "matrix" && numValues == 6)
+            t = AffineTransform(values[0], values[2], values[4], values[1], values[3], values[5]);
+        else if (name == "translate" && numValues >= 1)
+            t = AffineTransform::translation(values[0], numValues > 1 ? values[1] : 0.0f);
+        else if (name == "scale" && numValues >= 1)
+            t = AffineTransform::scale(values[0], numValues > 1 ? values[1] : values[0]);
+        else if (name == "rotate" && (numValues == 1 || numValues == 3))
+            t = AffineTransform::rotation(degreesToRadians(values[0]), values[1], values[2]);
+        else if (name == "skewX" && numValues == 1)
+            t = AffineTransform(1.0f, std::tan(degreesToRadians(values[0])), 0.0f, 0.0f, 1.0f, 0.0f);
+        else if (name == "skewY" && numValues == 1)
+            t = AffineTransform(1.0f, 0.0f, 0.0f, std::tan(degreesToRadians(values[0])), 1.0f, 0.0f);
+        else
+            warnings.add("Ignoring invalid transform '" + name + "'");
+        
+        // The rightmost transform in the list is applied to the coordinates first
+        result = t.followedBy(result);
+    }
+    
+    return result;
+}
+
+AffineTransform SvgParser::getNormalisation(const XmlElement& svg, const Rectangle<float>& viewBox)
+{
+    if (options.normalisation == Normalisation::none)
+        return {};
+    
+    if (viewBox.isEmpty())
+    {
+        warnings.add("Cannot normalise an svg without a viewBox or size");
+        return {};
+    }
+    
+    if (options.normalisation == Normalisation::unitSquare)
+        return RectanglePlacement(RectanglePlacement::stretchToFit).getTransformToFit(viewBox, {0.0f, 0.0f, 1.0f, 1.0f});
+    
+    const Rectangle<float> targetBounds(0.0f, 0.0f, options.targetWidth, options.targetHeight);
+    
+    if (options.normalisation == Normalisation::targetSize)
+        return RectanglePlacement(RectanglePlacement::stretchToFit).getTransformToFit(viewBox, targetBounds);
+    
+    // preserveAspectRatio="<align> [meet|slice]", defaulting to xMidYMid meet
+    auto aspect = svg.getStringAttribute("preserveAspectRatio", "xMidYMid meet").trim();
+    int flags = 0;
+    
+    if (aspect.startsWith("none"))
+    {
+        flags = RectanglePlacement::stretchToFit;
+    }
+    else
+    {
+        flags |= aspect.contains("xMin") ? RectanglePlacement::xLeft
+               : aspect.contains("xMax") ? RectanglePlacement::xRight : RectanglePlacement::xMid;
+        flags |= aspect.contains("YMin") ? RectanglePlacement::yTop
+               : aspect.contains("YMax") ? RectanglePlacement::yBottom : RectanglePlacement::yMid;
+        if (aspect.contains("slice"))
+            flags |= RectanglePlacement::fillDestination;
+    }
+    
+    return RectanglePlacement(flags).getTransformToFit(viewBox, targetBounds);
+}
+
+float SvgParser::parseLength(const String& length)
+{
+    // Absolute units are converted to CSS pixels, the user units of an svg without a viewBox.
+    // Percentages and font relative units depend on where the svg is placed, so they give no size.
+    static const std::pair<const char*, float> units[] = {
+        {"", 1.0f}, {"px", 1.0f}, {"pt", 4.0f / 3.0f}, {"pc", 16.0f}, {"mm", 96.0f / 25.4f}, {"cm", 96.0f / 2.54f},
+        {"in", 96.0f}
+    };
+    
+    const auto text = length.trim();
+    int unitStart = text.length();
+    while (unitStart > 0 && (CharacterFunctions::isLetter(text[unitStart - 1]) || text[unitStart - 1] == '%'))
+        --unitStart;
+    
+    const auto unit = text.substring(unitStart).toLowerCase();
+    
+    for (const auto& known: units)
+        if (unit == known.first)
+            return jmax(0.0f, text.substring(0, unitStart).getFloatValue() * known.second);
+    
+    return 0.0f;
+}
+
+String SvgParser::generateCode(const ShapeData& shape)
+{
+    MemoryOutputStream out;
+    generateCode(shape, out);
+    return out.toString();
+}
+
+void SvgParser::writeCoordinate(OutputStream& out, float value)
+{
+    // Formatted as f() formats, into a buffer on the stack
+    char text[64];
+    const int length = snprintf(text, sizeof(text), "%#.*ff", precision, (double) value);
+    out.write(text, (size_t) jlimit(0, (int) sizeof(text) - 1, length));
+}
+
+void SvgParser::generateCode(const ShapeData& shape, OutputStream& out)
+{
+    SVG2PATH_TRACE_SCOPE("generateCode");
+    
+    auto writeCall = [&](const char* function, std::initializer_list<float> values) {
+        out << "    path." << function << "(";
+        for (auto value = values.begin(); value != values.end(); ++value)
+        {
+            if (value != values.begin())
+                out << ", ";
+            writeCoordinate(out, *value);
+        }
+        out << ");\n";
+    };
+    
+    const float* c = shape.coords.data();
     
-    if (element->hasTagName("path"))
+    for (auto verb: shape.verbs)
     {
-        auto pathData = element->getStringAttribute("d");
-        if (!pathData.isEmpty())
+        switch (verb)
         {
-            pathDataList.push_back(pathData);
+            case ShapeData::subPath:
+                writeCall("startNewSubPath", {c[0], c[1]});
+                break;
+            case ShapeData::line:
+                writeCall("lineTo", {c[0], c[1]});
+                break;
+            case ShapeData::quadratic:
+                writeCall("quadraticTo", {c[0], c[1], c[2], c[3]});
+                break;
+            case ShapeData::cubic:
+                writeCall("cubicTo", {c[0], c[1], c[2], c[3], c[4], c[5]});
+                break;
+            case ShapeData::close:
+                out << "    path.closeSubPath();\n";
+                break;
+            case ShapeData::rectangle:
+            case ShapeData::ellipse:
+            {
+                auto r = Rectangle<float>(Point<float>(c[0], c[1]), Point<float>(c[2], c[3]));
+                writeCall(verb == ShapeData::rectangle ? "addRectangle" : "addEllipse",
+                          {r.getX(), r.getY(), r.getWidth(), r.getHeight()});
+                break;
+            }
+            case ShapeData::roundedRectangle:
+            {
+                auto r = Rectangle<float>(Point<float>(c[0], c[1]), Point<float>(c[2], c[3]));
+                writeCall("addRoundedRectangle", {r.getX(), r.getY(), r.getWidth(), r.getHeight(),
+                                                  std::abs(c[4] - c[0]), std::abs(c[5] - c[1])});
+                break;
+            }
+            default:
+                break;
         }
+        
+        c += ShapeData::getNumCoords(verb);
+    }
+}
+
+String SvgParser::getPartName(const ElementRecord& record, int index, const StringArray& usedNames)
+{
+    // Ids such as "eye-left" become eyeLeft, elements without one are named by tag and index
+    auto id = String(record.id).replaceCharacters("-", " ").trim();
+    auto name = id.isNotEmpty() ? build_tools::makeValidIdentifier(id, true, true, false)
+                                : record.element->getTagName() + String(index);
+    
+    // Names are unique by the function they become, so ids differing only in the case of their first
+    // letter don't clash. numParts is the enum's count.
+    auto isTaken = [&](const String& candidate) {
+        if (candidate == "numParts")
+            return true;
+        
+        for (const auto& used: usedNames)
+            if (getPartFunctionName(used) == getPartFunctionName(candidate))
+                return true;
+        
+        return false;
+    };
+    
+    auto unique = name;
+    for (int suffix = index; isTaken(unique); ++suffix)
+        unique = name + "_" + String(suffix);
+    
+    return unique;
+}
+
+String SvgParser::getPartFunctionName(const String& name)
+{
+    return "create" + name.substring(0, 1).toUpperCase() + name.substring(1) + "Path";
+}
+
+String SvgParser::generatePartsCode(const StringArray& names, const StringArray& bodies)
+{
+    String code;
+    code << "enum class PathPart\n";
+    code << "{\n";
+    for (const auto& name: names)
+        code << "    " << name << ",\n";
+    code << "    numParts\n";
+    code << "};\n\n";
+    
+    // Zero-length arrays don't compile, so without parts the same names are declared without them
+    if (names.isEmpty())
+    {
+        code << "static const char* const* const pathPartNames = nullptr;\n\n";
+        code << "//! the svg has no visible parts, every part is empty\n";
+        code << "Path createPath(PathPart)\n";
+        code << "{\n";
+        code << "    return {};\n";
+        code << "}\n";
+        
+        return code;
     }
     
-    // Recursively check all child elements
-    for (auto* child = element->getFirstChildElement(); child != nullptr; child = child->getNextElement())
+    for (int i = 0; i < names.size(); ++i)
     {
-        collectPaths(child, pathDataList);
+        code << "Path " << getPartFunctionName(names[i]) << "()\n";
+        code << "{\n";
+        code << "    Path path;\n";
+        code << bodies[i];
+        code << "    return path;\n";
+        code << "}\n\n";
     }
+    
+    code << "static const char* const pathPartNames[] = {";
+    for (int i = 0; i < names.size(); ++i)
+        code << (i > 0 ? ", " : "") << names[i].quoted();
+    code << "};\n\n";
+    
+    code << "//! creates only the requested part, so callers can build and draw the parts they need\n";
+    code << "Path createPath(PathPart part)\n";
+    code << "{\n";
+    code << "    static Path (*const factories[])() = {\n";
+    for (const auto& name: names)
+        code << "        " << getPartFunctionName(name) << ",\n";
+    code << "    };\n";
+    code << "    return factories[(int) part]();\n";
+    code << "}\n";
+    
+    return code;
 }
 
-String SvgParser::parse(String svgContent, Path& path)
+String SvgParser::generateLayersCode(const std::vector<Layer>& layers)
 {
-    // Parse the SVG content using JUCE's XML parsing
-    std::unique_ptr<XmlElement> svg(XmlDocument::parse(svgContent));
+    SVG2PATH_TRACE_SCOPE("generateLayersCode");
     
-    if (svg == nullptr)
+    ConversionArena::CodeOutputStream code(ConversionArena::getForThisThread());
+    code << "LayeredIcon createIcon()\n";
+    code << "{\n";
+    code << "    LayeredIcon icon;\n";
+    code << "    Path path;\n";
+    
+    bool nonZeroWinding = true;
+    for (size_t i = 0; i < layers.size(); ++i)
     {
-        return "Could not parse SVG content.";
+        const auto& layer = layers[i];
+        
+        code << "\n";
+        if (i > 0)
+            code << "    path.clear();\n";
+        
+        // The winding rule survives clearing the path, so it is only set where it changes
+        if (layer.nonZeroWinding != nonZeroWinding)
+        {
+            nonZeroWinding = layer.nonZeroWinding;
+            code << "    path.setUsingNonZeroWinding(" << (nonZeroWinding ? "true" : "false") << ");\n";
+        }
+        
+        generateCode(layer.shape, code);
+        code << "    icon.addLayer(path, Colour(0x" << String::toHexString((int) layer.colour.getARGB()).paddedLeft('0', 8)
+             << "));\n";
     }
     
-    // Get viewBox dimensions
-    auto viewBoxAttr = svg->getStringAttribute("viewBox");
-    float vbX = 0.0f, vbY = 0.0f, vbWidth = 1.0f, vbHeight = 1.0f;
+    code << "\n";
+    code << "    return icon;\n";
+    code << "}\n";
     
-    if (!viewBoxAttr.isEmpty())
+    return code.toString();
+}
+
+String SvgParser::getStyleValue(const XmlElement& element, const String& name)
+{
+    // A style property overrides the presentation attribute of the same name
+    auto style = element.getStringAttribute("style");
+    
+    if (style.contains(name))
     {
-        StringArray tokens;
-        tokens.addTokens(viewBoxAttr, " ,", "");
-        tokens.removeEmptyStrings();
-        
-        if (tokens.size() == 4)
+        for (const auto& declaration: StringArray::fromTokens(style, ";", ""))
         {
-            vbX = tokens[0].getFloatValue();
-            vbY = tokens[1].getFloatValue();
-            vbWidth = tokens[2].getFloatValue();
-            vbHeight = tokens[3].getFloatValue();
+            if (declaration.upToFirstOccurrenceOf(":", false, false).trim() == name)
+                return declaration.fromFirstOccurrenceOf(":", false, false).trim();
         }
     }
     
-    // Use the recursive function to collect all <path> elements
-    std::vector<String> pathDataList;
-    collectPaths(svg.get(), pathDataList);
+    return element.getStringAttribute(name).trim();
+}
+
+bool SvgParser::parseColour(const String& text, Colour currentColour, Colour& colour)
+{
+    auto value = text.trim().toLowerCase();
+    
+    // A paint server reference may be followed by a fallback colour
+    if (value.startsWith("url("))
+        value = value.fromFirstOccurrenceOf(")", false, false).trim();
+    
+    if (value.isEmpty() || value == "none")
+        return false;
     
-    if (pathDataList.empty())
+    if (value == "currentcolor")
     {
-        return "No path data found in SVG content.";
+        colour = currentColour;
+        return true;
     }
     
-    // Generate JUCE code for each path
-    String fullJuceCode;
-    fullJuceCode << "Path createPath()\n";
-    fullJuceCode << "{\n";
-    fullJuceCode << "    Path path;\n";
-    path.clear();
-    for (const auto& pathData: pathDataList)
+    if (value.startsWithChar('#'))
     {
-        auto juceCode = parseSVGPathData(pathData, path);
+        auto hex = value.substring(1);
+        if (!hex.containsOnly("0123456789abcdef"))
+            return false;
         
-        if (juceCode.isEmpty())
+        // #rgb and #rgba repeat each digit
+        if (hex.length() == 3 || hex.length() == 4)
         {
-            return "Error parsing path data.";
+            String expanded;
+            for (auto c: hex)
+                expanded << c << c;
+            hex = expanded;
         }
         
-        fullJuceCode << juceCode;
+        if (hex.length() == 6)
+            hex << "ff";
+        
+        if (hex.length() != 8)
+            return false;
+        
+        const auto rgba = (uint32) hex.getHexValue32();
+        colour = Colour((uint8) (rgba >> 24), (uint8) (rgba >> 16), (uint8) (rgba >> 8), (uint8) rgba);
+        return true;
     }
     
-    fullJuceCode << "    return path;\n";
-    fullJuceCode << "}\n";
+    if (value.startsWith("rgb"))
+    {
+        auto tokens = StringArray::fromTokens(value.fromFirstOccurrenceOf("(", false, false)
+                                                   .upToFirstOccurrenceOf(")", false, false), ", /", "");
+        tokens.removeEmptyStrings();
+        
+        if (tokens.size() < 3)
+            return false;
+        
+        auto getChannel = [&](int index) {
+            const auto& token = tokens[index];
+            return (uint8) jlimit(0, 255, roundToInt(token.endsWithChar('%') ? token.getFloatValue() * 2.55f
+                                                                             : token.getFloatValue()));
+        };
+        
+        float alpha = 1.0f;
+        if (tokens.size() > 3)
+            alpha = jlimit(0.0f, 1.0f, tokens[3].endsWithChar('%') ? tokens[3].getFloatValue() / 100.0f
+                                                                   : tokens[3].getFloatValue());
+        
+        colour = Colour(getChannel(0), getChannel(1), getChannel(2), alpha);
+        return true;
+    }
+    
+    if (value == "transparent")
+    {
+        colour = Colours::transparentBlack;
+        return true;
+    }
+    
+    // juce knows the svg colour keywords, anything else is left alone
+    const auto named = Colours::findColourForName(value, Colours::transparentBlack);
+    if (named == Colours::transparentBlack)
+        return false;
     
-    return fullJuceCode;
+    colour = named;
+    return true;
 }
 
-String SvgParser::getBinary(Path& path, String name)
+SvgParser::Style SvgParser::getStyle(const XmlElement& element, const Style& parentStyle)
 {
+    // Every property used here is inherited, so start from the parent's
+    Style style = parentStyle;
+    
+    // Read first, so a currentColor on the same element paints with it
+    auto colour = getStyleValue(element, "color");
+    if (colour.isNotEmpty() && colour != "inherit")
+        parseColour(colour, parentStyle.currentColour, style.currentColour);
+    
+    // Paints this parser can't resolve, such as gradients, keep the inherited colour
+    auto fill = getStyleValue(element, "fill");
+    if (fill.isNotEmpty() && fill != "inherit")
+    {
+        style.filled = fill != "none";
+        parseColour(fill, style.currentColour, style.fillColour);
+    }
+    
+    auto stroke = getStyleValue(element, "stroke");
+    if (stroke.isNotEmpty() && stroke != "inherit")
+    {
+        style.stroked = stroke != "none";
+        parseColour(stroke, style.currentColour, style.strokeColour);
+    }
+    
+    auto getOpacity = [&](const String& name, float inherited) {
+        auto value = getStyleValue(element, name);
+        if (value.isEmpty() || value == "inherit")
+            return inherited;
+        
+        return jlimit(0.0f, 1.0f, value.endsWithChar('%') ? value.getFloatValue() / 100.0f : value.getFloatValue());
+    };
+    
+    style.fillOpacity = getOpacity("fill-opacity", style.fillOpacity);
+    style.strokeOpacity = getOpacity("stroke-opacity", style.strokeOpacity);
+    
+    // Group opacity is applied to each child, which differs from the svg result only where children overlap
+    style.opacity *= getOpacity("opacity", 1.0f);
+    
+    auto fillRule = getStyleValue(element, "fill-rule");
+    if (fillRule == "evenodd")
+        style.nonZeroWinding = false;
+    else if (fillRule == "nonzero")
+        style.nonZeroWinding = true;
+    
+    auto width = getStyleValue(element, "stroke-width");
+    if (width.isNotEmpty() && width != "inherit")
+        style.strokeWidth = jmax(0.0f, width.getFloatValue());
+    
+    auto join = getStyleValue(element, "stroke-linejoin");
+    if (join == "round")
+        style.joint = PathStrokeType::curved;
+    else if (join == "bevel")
+        style.joint = PathStrokeType::beveled;
+    else if (join == "miter" || join == "miter-clip" || join == "arcs")
+        style.joint = PathStrokeType::mitered;
+    
+    auto cap = getStyleValue(element, "stroke-linecap");
+    if (cap == "round")
+        style.cap = PathStrokeType::rounded;
+    else if (cap == "square")
+        style.cap = PathStrokeType::square;
+    else if (cap == "butt")
+        style.cap = PathStrokeType::butt;
+    
+    // juce applies its own miter limit, so only a limit that rules out every miter is honoured
+    auto miterLimit = getStyleValue(element, "stroke-miterlimit");
+    if (miterLimit.isNotEmpty() && miterLimit.getFloatValue() <= 1.0f && style.joint == PathStrokeType::mitered)
+        style.joint = PathStrokeType::beveled;
+    
+    auto dashArray = getStyleValue(element, "stroke-dasharray");
+    if (dashArray == "none")
+    {
+        style.dashes.clear();
+    }
+    else if (dashArray.isNotEmpty() && dashArray != "inherit")
+    {
+        // An odd number of lengths is repeated to make an even one, and any invalid length turns dashing off
+        Array<float> dashes;
+        bool valid = true;
+        float total = 0.0f;
+        
+        for (const auto& token: StringArray::fromTokens(dashArray, ", ", ""))
+        {
+            if (token.isEmpty())
+                continue;
+            
+            const float length = token.getFloatValue();
+            valid = valid && length >= 0.0f;
+            total += length;
+            dashes.add(length);
+        }
+        
+        if (dashes.size() % 2 != 0)
+            dashes.addArray(Array<float>(dashes));
+        
+        style.dashes = valid && total > 0.0f ? dashes : Array<float>();
+    }
+    
+    auto dashOffset = getStyleValue(element, "stroke-dashoffset");
+    if (dashOffset.isNotEmpty() && dashOffset != "inherit")
+        style.dashOffset = dashOffset.getFloatValue();
+    
+    return style;
+}
+
+Path SvgParser::getDashedPath(const Path& path, const Array<float>& dashes, float dashOffset, float tolerance)
+{
+    float total = 0.0f;
+    for (auto dash: dashes)
+        total += dash;
+    
+    Path dashed;
+    int dashIndex = 0;
+    float remaining = 0.0f;
+    int subPathIndex = -1;
+    
+    for (PathFlatteningIterator it(path, {}, tolerance); it.next();)
+    {
+        // The pattern restarts at every sub-path, advanced by the offset
+        if (it.subPathIndex != subPathIndex)
+        {
+            subPathIndex = it.subPathIndex;
+            float offset = std::fmod(dashOffset, total);
+            if (offset < 0.0f)
+                offset += total;
+            
+            dashIndex = 0;
+            while (dashIndex < dashes.size() - 1 && offset >= dashes[dashIndex])
+                offset -= dashes[dashIndex++];
+            remaining = dashes[dashIndex] - offset;
+            
+            if (dashIndex % 2 == 0)
+                dashed.startNewSubPath(it.x1, it.y1);
+        }
+        
+        const Point<float> start(it.x1, it.y1), end(it.x2, it.y2);
+        const float length = start.getDistanceFrom(end);
+        float position = 0.0f;
+        
+        while (length - position > remaining)
+        {
+            position += remaining;
+            const auto point = start + (end - start) * (position / length);
+            
+            if (dashIndex % 2 == 0)
+                dashed.lineTo(point);
+            else
+                dashed.startNewSubPath(point);
+            
+            dashIndex = (dashIndex + 1) % dashes.size();
+            remaining = dashes[dashIndex];
+        }
+        
+        remaining -= length - position;
+        if (dashIndex % 2 == 0)
+            dashed.lineTo(end);
+    }
+    
+    return dashed;
+}
+
+void SvgParser::addStroke(const ShapeData& shape, const Style& style, ShapeData& outline)
+{
+    if (!style.stroked || style.strokeWidth <= 0.0f)
+        return;
+    
+    Path source;
+    shape.appendTo(source);
+    
+    if (!style.dashes.isEmpty())
+        source = getDashedPath(source, style.dashes, style.dashOffset, options.maxArcError);
+    
+    // Stroke each sub-path on its own and turn its outline the way rectangles turn, so the
+    // outline and any fill add up under the non-zero rule instead of cancelling out
+    PathStrokeType strokeType(style.strokeWidth, style.joint, style.cap);
+    Path subPath;
+    
+    auto strokeSubPath = [&]() {
+        if (subPath.isEmpty())
+            return;
+        
+        Path stroked;
+        strokeType.createStrokedPath(stroked, subPath, {},
+                                     Path::defaultToleranceForMeasurement / options.maxArcError);
+        
+        ShapeData strokedShape;
+        strokedShape.addPath(stroked);
+        if (strokedShape.getSignedArea(options.maxArcError) < 0.0f)
+            strokedShape.reverse();
+        
+        outline.append(strokedShape);
+        subPath.clear();
+    };
+    
+    for (Path::Iterator it(source); it.next();)
+    {
+        switch (it.elementType)
+        {
+            case Path::Iterator::startNewSubPath:
+                strokeSubPath();
+                subPath.startNewSubPath(it.x1, it.y1);
+                break;
+            case Path::Iterator::lineTo:
+                subPath.lineTo(it.x1, it.y1);
+                break;
+            case Path::Iterator::quadraticTo:
+                subPath.quadraticTo(it.x1, it.y1, it.x2, it.y2);
+                break;
+            case Path::Iterator::cubicTo:
+                subPath.cubicTo(it.x1, it.y1, it.x2, it.y2, it.x3, it.y3);
+                break;
+            case Path::Iterator::closePath:
+                subPath.closeSubPath();
+                break;
+        }
+    }
+    
+    strokeSubPath();
+}
+
+bool SvgParser::isDefinition(const XmlElement& element)
+{
+    return element.hasTagName("defs") || element.hasTagName("clipPath") || element.hasTagName("mask");
+}
+
+bool SvgParser::isDrawable(const XmlElement& element)
+{
+    return element.hasTagName("path") || element.hasTagName("rect") || element.hasTagName("circle")
+        || element.hasTagName("ellipse") || element.hasTagName("line") || element.hasTagName("polyline")
+        || element.hasTagName("polygon");
+}
+
+bool SvgParser::setsStyle(const XmlElement& element)
+{
+    static const char* const properties[] = {
+        "style", "color", "fill", "stroke", "fill-opacity", "stroke-opacity", "opacity", "fill-rule",
+        "stroke-width", "stroke-linejoin", "stroke-linecap", "stroke-miterlimit", "stroke-dasharray",
+        "stroke-dashoffset"
+    };
+    
+    for (auto* property: properties)
+        if (element.hasAttribute(property))
+            return true;
+    
+    return false;
+}
+
+int SvgParser::addRecord(XmlElement* element, int parent, Document& document)
+{
+    ElementRecord record{element, element->getStringAttribute("id"), parent, 0, -1, -1, document.rootTransform,
+                         isDrawable(*element)};
+    
+    if (parent >= 0)
+    {
+        const auto& parentRecord = document.records[(size_t) parent];
+        record.depth = parentRecord.depth + 1;
+        record.style = parentRecord.style;
+        record.transform = parentRecord.transform;
+    }
+    
+    // Every style property is inherited, so an element that sets none draws with its parent's style
+    if (record.style < 0 || setsStyle(*element))
+    {
+        auto style = getStyle(*element, record.style < 0 ? Style() : document.styles[(size_t) record.style]);
+        document.styles.push_back(std::move(style));
+        record.style = (int) document.styles.size() - 1;
+    }
+    
+    // Compose the transform once per element, so children of a group all share the result.
+    // Elements without a transform just pass their parent's on.
+    if (element->hasAttribute("transform"))
+        record.transform = parseTransform(element->getStringAttribute("transform")).followedBy(record.transform);
+    
+    if (record.drawable)
+        ++document.numDrawable;
+    
+    document.records.push_back(record);
+    return (int) document.records.size() - 1;
+}
+
+void SvgParser::resolveClipPaths(Document& document)
+{
+    if (!options.applyClipPaths)
+        return;
+    
+    // Parents are recorded before their children, so each record can take its parent's clip first
+    for (auto& record: document.records)
+    {
+        if (record.parent >= 0)
+            record.clip = document.records[(size_t) record.parent].clip;
+        
+        ShapeData clip;
+        if (getClipPath(*document.svg, *record.element, record.transform, clip))
+        {
+            document.clips.push_back({std::move(clip), record.clip});
+            record.clip = (int) document.clips.size() - 1;
+        }
+    }
+}
+
+XmlElement* SvgParser::findElementById(const XmlElement& element, const String& id)
+{
+    // Depth first in document order, with the next sibling of each open level on a stack
+    ArenaVector<XmlElement*> next;
+    next.push_back(element.getFirstChildElement());
+    
+    while (!next.empty())
+    {
+        auto* child = next.back();
+        
+        if (child == nullptr)
+        {
+            next.pop_back();
+            continue;
+        }
+        
+        if (child->getStringAttribute("id") == id)
+            return child;
+        
+        next.back() = child->getNextElement();
+        next.push_back(child->getFirstChildElement());
+    }
+    
+    return nullptr;
+}
+
+bool SvgParser::getClipPath(const XmlElement& svg, const XmlElement& element, const AffineTransform& transform,
+                            ShapeData& clip)
+{
+    auto reference = getStyleValue(element, "clip-path").trim();
+    if (!reference.startsWith("url("))
+        return false;
+    
+    auto id = reference.fromFirstOccurrenceOf("#", false, false).upToFirstOccurrenceOf(")", false, false);
+    auto* clipPath = findElementById(svg, id.unquoted().trim());
+    
+    // A reference that doesn't resolve is ignored, like browsers do
+    if (clipPath == nullptr || !clipPath->hasTagName("clipPath"))
+        return false;
+    
+    // The clip's coordinates are in the user space of the element that references it
+    auto clipTransform = transform;
+    if (clipPath->hasAttribute("transform"))
+        clipTransform = parseTransform(clipPath->getStringAttribute("transform")).followedBy(transform);
+    
+    for (auto* child = clipPath->getFirstChildElement(); child != nullptr; child = child->getNextElement())
+    {
+        ShapeData part;
+        if (!parseShape(*child, part) || part.isEmpty())
+            continue;
+        
+        auto childTransform = clipTransform;
+        if (child->hasAttribute("transform"))
+            childTransform = parseTransform(child->getStringAttribute("transform")).followedBy(clipTransform);
+        
+        // clip-rule is inherited from the clipPath element, and defaults to nonzero
+        auto clipRule = getStyleValue(*child, "clip-rule");
+        if (clipRule.isEmpty() || clipRule == "inherit")
+            clipRule = getStyleValue(*clipPath, "clip-rule");
+        
+        // The region is the union of the children, which orienting each for its clip rule gives under non-zero
+        part.applyTransform(childTransform);
+        part.orientContours(clipRule != "evenodd", options.maxArcError);
+        
+        clip.append(part);
+    }
+    
+    return true;
+}
+
+void SvgParser::mergeOverlappingShapes(ArenaVector<ShapeData>& shapes, float tolerance)
+{
+    SVG2PATH_TRACE_SCOPE("mergeOverlappingShapes");
+    
+    // Coverage is measured with the whole icon at 256px, so the report doesn't depend on the output units
+    const int coverageSize = 256;
+    std::vector<Rectangle<float>> bounds;
+    Rectangle<float> area;
+    
+    for (const auto& shape: shapes)
+    {
+        Path path;
+        shape.appendTo(path);
+        bounds.push_back(path.getBounds());
+        area = area.getUnion(bounds.back());
+    }
+    
+    for (const auto& shape: shapes)
+    {
+        mergeReport.edgesBefore += PathBoolean::countEdges(shape, tolerance);
+        mergeReport.pixelsBefore += PathBoolean::getCoverage(shape, area, coverageSize);
+    }
+    
+    // Cluster shapes whose bounds overlap, directly or through a chain of other shapes
+    std::vector<size_t> parents(shapes.size());
+    for (size_t i = 0; i < parents.size(); ++i)
+        parents[i] = i;
+    
+    auto findRoot = [&](size_t i) {
+        while (parents[i] != i)
+            i = parents[i] = parents[parents[i]];
+        return i;
+    };
+    
+    for (size_t i = 0; i < shapes.size(); ++i)
+        for (size_t j = i + 1; j < shapes.size(); ++j)
+            if (bounds[i].intersects(bounds[j]))
+                parents[findRoot(j)] = findRoot(i);
+    
+    std::map<size_t, std::vector<size_t>> clusters;
+    for (size_t i = 0; i < shapes.size(); ++i)
+        clusters[findRoot(i)].push_back(i);
+    
+    // Each cluster is replaced by its union, in place of its first shape
+    for (const auto& cluster: clusters)
+    {
+        const auto& members = cluster.second;
+        if (members.size() < 2)
+            continue;
+        
+        std::vector<ShapeData> operands;
+        for (auto index: members)
+        {
+            operands.push_back(std::move(shapes[index]));
+            shapes[index].clear();
+        }
+        
+        shapes[members.front()] = PathBoolean::getUnion(operands, tolerance);
+        mergeReport.numShapesMerged += (int) members.size();
+        ++mergeReport.numOutlines;
+    }
+    
+    for (const auto& shape: shapes)
+    {
+        mergeReport.edgesAfter += PathBoolean::countEdges(shape, tolerance);
+        mergeReport.pixelsAfter += PathBoolean::getCoverage(shape, area, coverageSize);
+    }
+}
+
+String SvgParser::parse(String svgContent, Path& path)
+{
+    ShapeData shapes;
+    return parse(svgContent, path, shapes);
+}
+
+void SvgParser::initialiseDocument(Document& document)
+{
+    const auto& svg = *document.svg;
+    
+    // Get viewBox dimensions, falling back on the svg's size
+    auto viewBoxAttr = svg.getStringAttribute("viewBox");
+    float vbX = 0.0f, vbY = 0.0f;
+    float vbWidth = parseLength(svg.getStringAttribute("width"));
+    float vbHeight = parseLength(svg.getStringAttribute("height"));
+    
+    if (!viewBoxAttr.isEmpty())
+    {
+        StringArray tokens;
+        tokens.addTokens(viewBoxAttr, " ,", "");
+        tokens.removeEmptyStrings();
+        
+        if (tokens.size() == 4)
+        {
+            vbX = tokens[0].getFloatValue();
+            vbY = tokens[1].getFloatValue();
+            vbWidth = tokens[2].getFloatValue();
+            vbHeight = tokens[3].getFloatValue();
+        }
+    }
+    
+    // The normalisation is the root of the transform stack, so it costs nothing extra per element
+    const Rectangle<float> viewBox(vbX, vbY, vbWidth, vbHeight);
+    const auto rootTransform = getNormalisation(svg, viewBox);
+    document.rootTransform = rootTransform;
+    
+    const auto outputArea = viewBox.transformedBy(rootTransform);
+    const float outputSize = jmax(outputArea.getWidth(), outputArea.getHeight());
+    
+    // One decimal is a fine grid in svg units, but not once the svg is scaled down to a unit square
+    // or a small target, so normalised coordinates get enough for a thousandth of the output size
+    precision = options.precision;
+    if (precision == autoPrecision)
+    {
+        precision = options.normalisation != Normalisation::none && outputSize > 0.0f
+            ? jlimit(0, 6, (int) std::ceil(std::log10(1000.0f / outputSize) - 1.0e-4f))
+            : 1;
+    }
+    
+    // The flattening tolerance is given in pixels at the render size, so convert it to output units
+    document.tolerance = 0.0f;
+    if (options.flatteningSize > 0.0f)
+    {
+        if (outputArea.isEmpty())
+            warnings.add("Cannot flatten an svg without a viewBox or size");
+        else
+            document.tolerance = options.flatteningTolerance * outputSize / options.flatteningSize;
+    }
+    
+    // Booleans flatten the curves they touch, as closely as flattening or else arc approximation asks
+    document.booleanTolerance = document.tolerance > 0.0f
+        ? document.tolerance
+        : jmax(1.0e-6f, options.maxArcError * std::sqrt(std::abs(rootTransform.getDeterminant())));
+}
+
+String SvgParser::fail(const String& message)
+{
+    error = message;
+    return message;
+}
+
+void SvgParser::setOptions(const Options& newOptions)
+{
+    setNormalisation(newOptions.normalisation, newOptions.targetWidth, newOptions.targetHeight);
+    setOutputMode(newOptions.outputMode);
+    setMaxArcError(newOptions.maxArcError);
+    setFlattening(newOptions.flatteningSize, newOptions.flatteningTolerance);
+    setPrecision(newOptions.precision);
+    setSimplification(newOptions.simplificationTolerance);
+    setQuantisation(newOptions.quantisationStep);
+    setMergeOverlaps(newOptions.mergeOverlaps);
+    setApplyClipPaths(newOptions.applyClipPaths);
+    setCodeGeneration(newOptions.codeGeneration);
+}
+
+template <typename Parse>
+SvgParser::Conversion SvgParser::convert(const Options& options, Parse&& parse)
+{
+    // The parser holds the state of this call only, so concurrent calls share nothing
+    SvgParser parser(options);
+    Conversion conversion;
+    String output;
+    
+    if (parser.options.outputMode == OutputMode::layers)
+    {
+        output = parse(parser, conversion.layers);
+        
+        for (const auto& layer: conversion.layers)
+        {
+            layer.shape.appendTo(conversion.path);
+            conversion.shapes.append(layer.shape);
+        }
+    }
+    else
+    {
+        output = parse(parser, conversion.path, conversion.shapes);
+    }
+    
+    conversion.error = parser.error;
+    conversion.code = conversion.wasSuccessful() ? output : String();
+    conversion.warnings = parser.warnings;
+    conversion.mergeReport = parser.mergeReport;
+    return conversion;
+}
+
+SvgParser::Conversion SvgParser::convert(const String& svgContent, const Options& options)
+{
+    return convert(options, [&](SvgParser& parser, auto&... results) { return parser.parse(svgContent, results...); });
+}
+
+SvgParser::Conversion SvgParser::convert(const void* data, size_t size, const Options& options)
+{
+    return convert(options, [&](SvgParser& parser, auto&... results) { return parser.parse(data, size, results...); });
+}
+
+String SvgParser::scanDocument(const void* data, size_t size, Document& document)
+{
+    SVG2PATH_TRACE_SCOPE("scanDocument");
+    
+    warnings.clear();
+    error.clear();
+    
+    // Each open element refers to the record its children inherit from. Recorded elements are
+    // kept by the document, without their children, so nothing is nested however deep the svg
+    // is. Clip paths are looked up once the whole svg is read, so they may come after their users.
+    struct OpenElement
+    {
+        XmlElement* element;
+        int record;
+        bool isDefinition;
+    };
+    
+    ArenaVector<OpenElement> openElements;
+    SvgScanner scanner(data, size);
+    
+    for (auto token = scanner.next(); token != SvgScanner::Token::end; token = scanner.next())
+    {
+        if (token == SvgScanner::Token::error)
+            return fail("Could not parse SVG content.");
+        
+        if (token == SvgScanner::Token::endTag)
+        {
+            if (openElements.empty() || !openElements.back().element->hasTagName(scanner.getTagName()))
+                return fail("Could not parse SVG content.");
+            
+            openElements.pop_back();
+            continue;
+        }
+        
+        auto element = scanner.takeElement();
+        OpenElement open{element.get(), -1, false};
+        
+        if (document.svg == nullptr)
+        {
+            document.svg = std::move(element);
+            initialiseDocument(document);
+            open.record = addRecord(open.element, -1, document);
+        }
+        else if (openElements.empty())
+        {
+            return fail("Could not parse SVG content.");
+        }
+        else
+        {
+            const auto& parent = openElements.back();
+            
+            if (parent.isDefinition || isDefinition(*open.element))
+            {
+                // Clip paths are looked up by id under the root, and only their own children are
+                // read, so those are the only definitions kept in a tree, two levels deep at most
+                if (open.element->hasTagName("clipPath"))
+                    document.svg->addChildElement(element.release());
+                else if (parent.element->hasTagName("clipPath"))
+                    parent.element->addChildElement(element.release());
+                else
+                    document.elements.add(element.release());
+                
+                open.isDefinition = true;
+            }
+            else
+            {
+                open.record = addRecord(open.element, parent.record, document);
+                document.elements.add(element.release());
+            }
+        }
+        
+        if (!scanner.isEmptyElement())
+            openElements.push_back(std::move(open));
+    }
+    
+    if (document.svg == nullptr || !openElements.empty())
+        return fail("Could not parse SVG content.");
+    
+    resolveClipPaths(document);
+    
+    if (document.numDrawable == 0)
+        return fail("No path data found in SVG content.");
+    
+    return {};
+}
+
+bool SvgParser::getShapes(const ElementRecord& record, const Document& document, ShapeData& fill,
+                          ShapeData& stroke)
+{
+    ShapeData outline;
+    
+    if (!parseShape(*record.element, outline))
+        return false;
+    
+    // Strokes are expanded into outlines here, so the emitted geometry only ever needs filling
+    const auto& style = document.styles[(size_t) record.style];
+    
+    if (style.filled)
+    {
+        fill = outline;
+        if (style.stroked && fill.getSignedArea(options.maxArcError) < 0.0f)
+            fill.reverse();
+    }
+    
+    addStroke(outline, style, stroke);
+    
+    for (auto* shape: {&fill, &stroke})
+    {
+        if (shape->isEmpty())
+            continue;
+        
+        shape->applyTransform(record.transform);
+        
+        // Clip regions are turned to fill under non-zero, and the loops an intersection returns
+        // fill the same area under either rule, so only the first intersection sees the fill rule
+        bool nonZeroWinding = shape == &stroke || style.nonZeroWinding;
+        
+        for (int clip = record.clip; clip >= 0; clip = document.clips[(size_t) clip].parent)
+        {
+            *shape = PathBoolean::getIntersection(*shape, nonZeroWinding, document.clips[(size_t) clip].shape, true,
+                                                  document.booleanTolerance);
+            nonZeroWinding = true;
+        }
+        
+        shape->flatten(document.tolerance);
+    }
+    
+    return true;
+}
+
+String SvgParser::parse(String svgContent, Path& path, ShapeData& shapes)
+{
+    SVG2PATH_TRACE_SCOPE("SvgParser::parse");
+    
+    // The document's records live in the arena, which is released when the conversion ends
+    ConversionArena::ScopedConversion conversion;
+    Document document;
+    auto error = scanDocument(svgContent.toRawUTF8(), svgContent.getNumBytesAsUTF8(), document);
+    return error.isNotEmpty() ? error : convert(document, path, shapes);
+}
+
+String SvgParser::parse(const void* data, size_t size, Path& path, ShapeData& shapes)
+{
+    SVG2PATH_TRACE_SCOPE("SvgParser::parse");
+    
+    // The document's records live in the arena, which is released when the conversion ends
+    ConversionArena::ScopedConversion conversion;
+    Document document;
+    auto error = scanDocument(data, size, document);
+    return error.isNotEmpty() ? error : convert(document, path, shapes);
+}
+
+String SvgParser::convert(const Document& document, Path& path, ShapeData& shapes)
+{
+    shapes.clear();
+    path.clear();
+    
+    // Layers carry their own paint, the path only gets their combined geometry
+    if (options.outputMode == OutputMode::layers)
+    {
+        std::vector<Layer> layers;
+        auto code = convert(document, layers);
+        
+        for (const auto& layer: layers)
+        {
+            layer.shape.appendTo(path);
+            shapes.append(layer.shape);
+        }
+        
+        return code;
+    }
+    
+    ArenaVector<ShapeData> elementShapes;
+    ArenaVector<const ElementRecord*> sources;
+    for (const auto& record: document.records)
+    {
+        if (!record.drawable)
+            continue;
+        
+        ShapeData shape, stroke;
+        
+        if (!getShapes(record, document, shape, stroke))
+        {
+            return fail("Error parsing " + record.element->getTagName() + " data.");
+        }
+        
+        shape.append(stroke);
+        
+        if (shape.isEmpty())
+            continue;
+        
+        elementShapes.push_back(std::move(shape));
+        sources.push_back(&record);
+    }
+    
+    // Every shape in the single path shares one fill, so overlaps can be merged without changing the result
+    mergeReport = {};
+    if (options.mergeOverlaps && options.outputMode == OutputMode::singlePath)
+        mergeOverlappingShapes(elementShapes, document.booleanTolerance);
+    
+    for (auto& shape: elementShapes)
+    {
+        shape.simplify(options.simplificationTolerance);
+        shape.quantise(options.quantisationStep);
+    }
+    
+    // Generate JUCE code for each element
+    ConversionArena::CodeOutputStream fullJuceCode(ConversionArena::getForThisThread());
+    fullJuceCode << "Path createPath()\n";
+    fullJuceCode << "{\n";
+    
+    if (options.codeGeneration && mergeReport.numShapesMerged > 0)
+    {
+        fullJuceCode << "    // Merged " << mergeReport.numShapesMerged << " overlapping shapes into "
+                     << mergeReport.numOutlines << ": " << mergeReport.edgesBefore << " -> "
+                     << mergeReport.edgesAfter << " edges, "
+                     << String(100.0 * (1.0 - mergeReport.pixelsAfter / jmax(1.0, mergeReport.pixelsBefore)), 1)
+                     << "% fewer pixels filled\n";
+    }
+    
+    fullJuceCode << "    Path path;\n";
+    StringArray partNames, partBodies;
+    for (size_t i = 0; i < elementShapes.size(); ++i)
+    {
+        const auto& shape = elementShapes[i];
+        if (shape.isEmpty())
+            continue;
+        
+        shape.appendTo(path);
+        shapes.append(shape);
+        
+        if (!options.codeGeneration)
+            continue;
+        
+        if (options.outputMode == OutputMode::pathPerElement)
+        {
+            partNames.add(getPartName(*sources[i], partNames.size(), partNames));
+            partBodies.add(generateCode(shape));
+        }
+        else
+        {
+            generateCode(shape, fullJuceCode);
+        }
+    }
+    
+    if (!options.codeGeneration)
+        return {};
+    
+    if (options.outputMode == OutputMode::pathPerElement)
+    {
+        if (partNames.isEmpty())
+            warnings.add("The svg has no visible shapes, every part is empty");
+        
+        return generatePartsCode(partNames, partBodies);
+    }
+    
+    fullJuceCode << "    return path;\n";
+    fullJuceCode << "}\n";
+    
+    return fullJuceCode.toString();
+}
+
+String SvgParser::parse(String svgContent, std::vector<Layer>& layers)
+{
+    SVG2PATH_TRACE_SCOPE("SvgParser::parse");
+    
+    // The document's records live in the arena, which is released when the conversion ends
+    ConversionArena::ScopedConversion conversion;
+    Document document;
+    auto error = scanDocument(svgContent.toRawUTF8(), svgContent.getNumBytesAsUTF8(), document);
+    return error.isNotEmpty() ? error : convert(document, layers);
+}
+
+String SvgParser::parse(const void* data, size_t size, std::vector<Layer>& layers)
+{
+    SVG2PATH_TRACE_SCOPE("SvgParser::parse");
+    
+    // The document's records live in the arena, which is released when the conversion ends
+    ConversionArena::ScopedConversion conversion;
+    Document document;
+    auto error = scanDocument(data, size, document);
+    return error.isNotEmpty() ? error : convert(document, layers);
+}
+
+String SvgParser::convert(const Document& document, std::vector<Layer>& layers)
+{
+    layers.clear();
+    
+    ArenaVector<Rectangle<float>> layerBounds;
+    
+    auto addShape = [&](ShapeData shape, Colour colour, bool nonZeroWinding) {
+        if (shape.isEmpty() || colour.isTransparent())
+            return;
+        
+        shape.simplify(options.simplificationTolerance);
+        shape.quantise(options.quantisationStep);
+        
+        // With every outline turned the same way, shapes in one layer add up under non-zero winding
+        // instead of cancelling out, which takes each contour's own turn rather than the shape's
+        if (nonZeroWinding)
+            shape.orientContours(true, document.booleanTolerance);
+        
+        Path path;
+        shape.appendTo(path);
+        const auto bounds = path.getBounds();
+        
+        // Search down for a layer of the same paint, as long as nothing in between overlaps the shape.
+        // Overlapping shapes only join where one fill looks like two: opaque and non-zero.
+        for (auto i = layers.size(); i-- > 0;)
+        {
+            auto& layer = layers[i];
+            const bool overlaps = layerBounds[i].intersects(bounds);
+            
+            if (layer.colour == colour && layer.nonZeroWinding == nonZeroWinding
+                && (!overlaps || (nonZeroWinding && colour.isOpaque())))
+            {
+                layer.shape.append(shape);
+                layerBounds[i] = layerBounds[i].getUnion(bounds);
+                return;
+            }
+            
+            if (overlaps)
+                break;
+        }
+        
+        layers.push_back({std::move(shape), colour, nonZeroWinding});
+        layerBounds.push_back(bounds);
+    };
+    
+    for (const auto& record: document.records)
+    {
+        if (!record.drawable)
+            continue;
+        
+        ShapeData fill, stroke;
+        
+        if (!getShapes(record, document, fill, stroke))
+        {
+            return fail("Error parsing " + record.element->getTagName() + " data.");
+        }
+        
+        // The stroke is painted over the fill, both with the element's opacity
+        const auto& style = document.styles[(size_t) record.style];
+        addShape(std::move(fill), style.fillColour.withMultipliedAlpha(style.fillOpacity * style.opacity),
+                 style.nonZeroWinding);
+        addShape(std::move(stroke), style.strokeColour.withMultipliedAlpha(style.strokeOpacity * style.opacity), true);
+    }
+    
+    return options.codeGeneration ? generateLayersCode(layers) : String();
+}
+
+String SvgParser::getBinary(Path& path, String name)
+{
+    SVG2PATH_TRACE_SCOPE("getBinary");
+    
     if (!path.isEmpty())
     {
         MemoryOutputStream data;
@@ -1,33 +1,310 @@
 #pragma once
 
-#include <JuceHeader.h>
-#include <iostream>
-#include <fstream>
+#include "CoreIncludes.h"
+#include "ShapeData.h"
+#include "ConversionArena.h"
 #include <string>
-#include <sstream>
 #include <cctype>
 
 class SvgParser
 {
 public:
     //==============================================================================
+    //! @brief how the emitted coordinates are mapped from the svg's viewBox
+    enum class Normalisation
+    {
+        none,       // keep the svg user units
+        unitSquare, // stretch the viewBox onto 0..1 on both axes
+        targetSize, // stretch the viewBox onto 0..targetWidth, 0..targetHeight
+        fit         // place the viewBox in the target size as the svg's preserveAspectRatio asks
+    };
+    
+    //! @brief the precision that follows the output scale, see setPrecision
+    static constexpr int autoPrecision = -1;
+    
+    //! @brief the shape of the generated code
+    enum class OutputMode
+    {
+        singlePath,     // one createPath() with every element merged
+        pathPerElement, // one named create function per element, plus an enum and a lookup table
+        layers          // one createIcon() that builds a LayeredIcon with a path per paint
+    };
+    
+    //! @brief the fill geometry of all elements that share one paint, drawn in order
+    struct Layer
+    {
+        ShapeData shape;
+        Colour colour;
+        bool nonZeroWinding{true};
+    };
+    
+    //! @brief what merging overlapping shapes saved in the last parse
+    struct MergeReport
+    {
+        int numShapesMerged{0};     // shapes that overlapped another and were merged
+        int numOutlines{0};         // outlines the merged shapes were replaced with
+        int edgesBefore{0};         // line segments filled, once flattened, before and after merging
+        int edgesAfter{0};
+        double pixelsBefore{0.0};   // pixels rasterized at 256px, counting overdrawn pixels once per shape
+        double pixelsAfter{0.0};
+    };
+    
+    //! @brief every setting of a conversion, as the setters below change them
+    struct Options
+    {
+        Normalisation normalisation{Normalisation::none};
+        float targetWidth{1.0f};
+        float targetHeight{1.0f};
+        OutputMode outputMode{OutputMode::singlePath};
+        float maxArcError{0.01f};
+        float flatteningSize{0.0f};      // the render size curves are flattened for, 0 keeps curves
+        float flatteningTolerance{0.2f}; // in pixels at that size
+        int precision{autoPrecision};    // decimals of emitted coordinates, see setPrecision
+        float simplificationTolerance{0.0f};
+        float quantisationStep{0.0f};
+        bool mergeOverlaps{false};
+        bool applyClipPaths{false};
+        bool codeGeneration{true};
+    };
+    
+    //! @brief everything one conversion produced, and what went wrong on the way
+    struct Conversion
+    {
+        String code;               // the generated code, empty if it failed or code generation is off
+        String error;              // why the conversion failed, empty if it succeeded
+        StringArray warnings;      // input that was skipped or ignored, in the order it was found
+        Path path;
+        ShapeData shapes;
+        std::vector<Layer> layers; // only filled in the layers output mode
+        MergeReport mergeReport;
+        
+        bool wasSuccessful() const { return error.isEmpty(); }
+    };
+    
     SvgParser() {};
+    //! @brief creates a parser with the given settings, limited as the setters limit them
+    explicit SvgParser(const Options& newOptions) { setOptions(newOptions); };
     ~SvgParser() {};
+    //! @brief converts an svg with a parser of its own, so any number of threads can convert at once
+    //! Nothing is shared between calls and nothing is written to the console, problems are
+    //! returned in the result instead.
+    //! @arg svgContent: the svg string
+    //! @arg options: the settings to convert with
+    static Conversion convert(const String& svgContent, const Options& options);
+    //! @brief converts svg data straight from memory, reading tags as they come instead of building an xml tree
+    //! @arg data: the svg's utf-8 bytes
+    //! @arg size: the size of the data in bytes
+    //! @arg options: the settings to convert with
+    static Conversion convert(const void* data, size_t size, const Options& options);
     //! @brief parse the svg file
+    //! Strings are read as utf-8 by SvgScanner, like svg data, and elements are kept in a flat
+    //! table, so no depth of nesting recurses.
     //! @arg svgContent: the svg string
     //! @arg path: a reference to the path to draw onto
     String parse(String svgContent, Path& path);
+    //! @brief parse the svg file, also returning the parsed geometry before it is turned into a path
+    //! @arg svgContent: the svg string
+    //! @arg path: a reference to the path to draw onto
+    //! @arg shapes: receives the verbs and coords of all elements, with primitives kept compact
+    String parse(String svgContent, Path& path, ShapeData& shapes);
+    //! @brief parse the svg file into layers of one paint each, whatever the output mode
+    //! Fills and strokes become layers of their colour and opacity. A shape joins an earlier layer
+    //! with the same paint when nothing drawn in between overlaps it, and when filling the two at
+    //! once looks the same as filling them one after the other.
+    //! @arg svgContent: the svg string
+    //! @arg layers: receives the layers, bottom first
+    String parse(String svgContent, std::vector<Layer>& layers);
+    //! @brief parse svg data straight from memory, reading tags as they come instead of building an xml tree
+    //! @arg data: the svg's utf-8 bytes
+    //! @arg size: the size of the data in bytes
+    //! @arg path: a reference to the path to draw onto
+    //! @arg shapes: receives the verbs and coords of all elements, with primitives kept compact
+    String parse(const void* data, size_t size, Path& path, ShapeData& shapes);
+    //! @brief parse svg data straight from memory into layers of one paint each
+    String parse(const void* data, size_t size, std::vector<Layer>& layers);
     //! @brief returns a binary representation of the path
     //! @arg path: a reference to the path to read
     //! @arg name: an optional name for the exported path
     String getBinary(Path& path, String name);
+    //! @brief applies all settings at once, through the setters below
+    void setOptions(const Options& newOptions);
+    //! @brief returns the current settings
+    const Options& getOptions() const { return options; }
+    //! @brief chooses between one merged path and a separate path per element
+    void setOutputMode(OutputMode mode) { options.outputMode = mode; }
+    //! @brief sets the maximum distance an arc approximation may deviate from the true arc
+    //! @arg maxError: the tolerance in svg user units, arcs use as few cubic segments as this allows
+    void setMaxArcError(float maxError) { options.maxArcError = jmax(1.0e-4f, maxError); }
+    //! @brief bakes a viewBox normalisation into all emitted coordinates
+    //! @arg mode: how to map the viewBox
+    //! @arg targetWidth: the output width for targetSize and fit
+    //! @arg targetHeight: the output height for targetSize and fit
+    void setNormalisation(Normalisation mode, float targetWidth = 1.0f, float targetHeight = 1.0f)
+    {
+        options.normalisation = mode;
+        options.targetWidth = jmax(0.0f, targetWidth);
+        options.targetHeight = jmax(0.0f, targetHeight);
+    }
+    //! @brief flattens all curves into lines for paths that are always drawn at a known size
+    //! @arg renderSize: the size in pixels the larger side of the viewBox is drawn at, 0 keeps the curves
+    //! @arg pixelTolerance: the largest distance between a curve and its lines, in pixels at that size
+    void setFlattening(float renderSize, float pixelTolerance = 0.2f)
+    {
+        options.flatteningSize = jmax(0.0f, renderSize);
+        options.flatteningTolerance = jmax(0.01f, pixelTolerance);
+    }
+    //! @brief sets the number of decimal places emitted coordinates are written with
+    //! @arg decimalPlaces: 0 to 6, or autoPrecision for one decimal in svg units and, when the output
+    //! is normalised, enough for a thousandth of the output size
+    void setPrecision(int decimalPlaces)
+    {
+        options.precision = decimalPlaces == autoPrecision ? autoPrecision : jlimit(0, 6, decimalPlaces);
+    }
+    //! @brief drops line points that lie within a tolerance of the outline without them
+    //! @arg tolerance: the largest distance the outline may move, in output units, 0 keeps every point
+    void setSimplification(float tolerance) { options.simplificationTolerance = jmax(0.0f, tolerance); }
+    //! @brief rounds the geometry's coordinates to a grid before it is emitted
+    //! @arg step: the grid size in output units, 0 keeps the coordinates
+    void setQuantisation(float step) { options.quantisationStep = jmax(0.0f, step); }
+    //! @brief replaces overlapping shapes with the outline of their union, so no pixel is filled twice
+    //! Only applies to the single path output, where every shape shares one fill. Merged shapes are
+    //! emitted as lines.
+    void setMergeOverlaps(bool shouldMerge) { options.mergeOverlaps = shouldMerge; }
+    //! @brief intersects elements with the clipPath they reference, instead of ignoring it
+    void setApplyClipPaths(bool shouldApply) { options.applyClipPaths = shouldApply; }
+    //! @brief turns generating code off for callers that only want the geometry, parse then returns
+    //! an empty string on success
+    void setCodeGeneration(bool shouldGenerate) { options.codeGeneration = shouldGenerate; }
+    //! @brief returns what merging overlaps saved in the last parse
+    const MergeReport& getMergeReport() const { return mergeReport; }
+    //! @brief returns the input the last parse skipped or ignored, such as invalid transforms
+    const StringArray& getWarnings() const { return warnings; }
     
 private:
-    bool parseNumber(const String& s, int& index, float& number);
-    String parseSVGPathData(const String& pathData, Path& path);
-    void collectPaths(XmlElement* element, std::vector<String>& pathDataList);
+    // Lets the microbenchmarks time the private stages of a parse on their own, and the tests check them
+    friend struct SvgParserProbe;
+    friend class ArcTests;
+    
+    //! @brief the inherited presentation attributes that decide how an element is drawn
+    struct Style
+    {
+        bool filled{true};
+        bool stroked{false};
+        float strokeWidth{1.0f};
+        PathStrokeType::JointStyle joint{PathStrokeType::mitered};
+        PathStrokeType::EndCapStyle cap{PathStrokeType::butt};
+        Array<float> dashes;
+        float dashOffset{0.0f};
+        Colour fillColour{Colours::black};
+        Colour strokeColour{Colours::black};
+        Colour currentColour{Colours::black}; // the color property, which currentColor paints with
+        float fillOpacity{1.0f};
+        float strokeOpacity{1.0f};
+        float opacity{1.0f};                  // the product of the element's and its ancestors' opacity
+        bool nonZeroWinding{true};
+    };
+    
+    //! @brief an element of the svg with the composed transform, style and clips of its ancestors and itself
+    //! Inherited attributes are stored once and referred to by index, so an element that sets no
+    //! style or clip of its own shares its parent's instead of copying them.
+    struct ElementRecord
+    {
+        XmlElement* element;
+        StringRef id;              // a view of the element's id attribute, empty without one
+        int parent;                // the parent's record, -1 for the root
+        int depth;                 // 0 for the root
+        int style;                 // the index into the document's styles
+        int clip;                  // the index into the document's clips of the innermost clip, -1 for none
+        AffineTransform transform;
+        bool drawable;
+    };
+    
+    //! @brief a clip region in output units, linked to the clip of the ancestors it is drawn within
+    struct ClipRecord
+    {
+        ShapeData shape;
+        int parent; // the next clip out, -1 for none
+    };
+    
+    //! @brief a parsed svg with its elements in document order and the tolerances that follow from its size
+    //! Lives for one conversion, with its element records in the thread's ConversionArena.
+    struct Document
+    {
+        std::unique_ptr<XmlElement> svg; // the root, with the clip paths under it
+        OwnedArray<XmlElement> elements; // every other element, without its children
+        ArenaVector<ElementRecord> records;
+        ArenaVector<Style> styles;
+        ArenaVector<ClipRecord> clips;
+        int numDrawable{0};
+        AffineTransform rootTransform; // the normalisation, which the root element's transform follows
+        float tolerance{0.0f};         // the flattening tolerance in output units, 0 keeps curves
+        float booleanTolerance{0.0f};  // the tolerance booleans flatten curves to
+    };
+    
+    //! @brief utf-8 text indexed by byte, read in place
+    //! Indexing a String walks its utf-8 from the start, which made reading long path data quadratic.
+    //! The numbers and commands read through a view are ascii, so each byte is a character.
+    struct TextView
+    {
+        TextView(const String& s) : text(s.toRawUTF8()), size((int) s.getNumBytesAsUTF8()) {}
+        juce_wchar operator[](int index) const { return index < size ? (juce_wchar) (uint8) text[index] : 0; }
+        int length() const { return size; }
+        
+        const char* text;
+        int size;
+    };
+    
+    bool parseNumber(const TextView& s, int& index, float& number);
+    bool parseFlag(const TextView& s, int& index, bool& flag);
+    bool parseSVGPathData(const TextView& pathData, ShapeData& shape);
+    bool parsePoints(const String& points, bool close, ShapeData& shape);
+    bool parseShape(const XmlElement& element, ShapeData& shape);
+    AffineTransform parseTransform(const String& transform);
+    static float parseLength(const String& length);
+    AffineTransform getNormalisation(const XmlElement& svg, const Rectangle<float>& viewBox);
+    String generateCode(const ShapeData& shape);
+    void generateCode(const ShapeData& shape, OutputStream& out);
+    void writeCoordinate(OutputStream& out, float value);
+    String generatePartsCode(const StringArray& names, const StringArray& bodies);
+    String generateLayersCode(const std::vector<Layer>& layers);
+    String getPartName(const ElementRecord& record, int index, const StringArray& usedNames);
+    static String getPartFunctionName(const String& name);
+    void addArc(float x1, float y1, float rx, float ry, float angle, bool largeArc, bool sweep,
+                float x2, float y2, ShapeData& shape);
+    static int getNumArcSegments(double radius, double sweepAngle, float maxError);
+    static bool isDefinition(const XmlElement& element);
+    static bool isDrawable(const XmlElement& element);
+    static bool setsStyle(const XmlElement& element);
+    int addRecord(XmlElement* element, int parent, Document& document);
+    void resolveClipPaths(Document& document);
+    static XmlElement* findElementById(const XmlElement& element, const String& id);
+    bool getClipPath(const XmlElement& svg, const XmlElement& element, const AffineTransform& transform, ShapeData& clip);
+    void mergeOverlappingShapes(ArenaVector<ShapeData>& shapes, float tolerance);
+    void initialiseDocument(Document& document);
+    String fail(const String& message);
+    template <typename Parse>
+    static Conversion convert(const Options& options, Parse&& parse);
+    String scanDocument(const void* data, size_t size, Document& document);
+    String convert(const Document& document, Path& path, ShapeData& shapes);
+    String convert(const Document& document, std::vector<Layer>& layers);
+    bool getShapes(const ElementRecord& record, const Document& document, ShapeData& fill, ShapeData& stroke);
+    static String getStyleValue(const XmlElement& element, const String& name);
+    static bool parseColour(const String& text, Colour currentColour, Colour& colour);
+    Style getStyle(const XmlElement& element, const Style& parentStyle);
+    void addStroke(const ShapeData& shape, const Style& style, ShapeData& outline);
+    static Path getDashedPath(const Path& path, const Array<float>& dashes, float dashOffset, float tolerance);
+    
+    // With no decimals the point is kept, so the literal stays a float
+    inline String f(float val) { return String::formatted("%#.*ff", precision, val); }
+    
+    static constexpr int maxArcSegments = 64;
+    Options options;
+    int precision{1}; // the decimals the options ask for, resolved for the svg being converted
     
-    inline String f(float val) { return String::formatted("%.1ff", val); }
+    // What the last parse found, reset when the next one starts
+    MergeReport mergeReport;
+    StringArray warnings;
+    String error;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SvgParser)
 };
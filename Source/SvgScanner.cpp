@@ -0,0 +1,226 @@
+#include "SvgScanner.h"
+
+SvgScanner::SvgScanner(const void* data, size_t size)
+    : position(static_cast<const char*>(data)), end(static_cast<const char*>(data) + (data != nullptr ? size : 0))
+{
+    // A utf-8 byte order mark is allowed before the prolog
+    if (end - position >= 3 && std::memcmp(position, "\xef\xbb\xbf", 3) == 0)
+        position += 3;
+}
+
+bool SvgScanner::skipPast(const char* terminator)
+{
+    const size_t length = std::strlen(terminator);
+    
+    for (; position + length <= end; ++position)
+    {
+        if (std::memcmp(position, terminator, length) == 0)
+        {
+            position += length;
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+bool SvgScanner::skipDoctype()
+{
+    // The internal subset in brackets may contain '>' of its own
+    int depth = 0;
+    
+    for (; position < end; ++position)
+    {
+        if (*position == '[')
+            ++depth;
+        else if (*position == ']')
+            --depth;
+        else if (*position == '>' && depth <= 0)
+        {
+            ++position;
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+void SvgScanner::skipWhitespace()
+{
+    while (position < end && (*position == ' ' || *position == '\t' || *position == '\r' || *position == '\n'))
+        ++position;
+}
+
+String SvgScanner::readName()
+{
+    const char* start = position;
+    
+    while (position < end && *position != ' ' && *position != '\t' && *position != '\r' && *position != '\n'
+           && *position != '/' && *position != '>' && *position != '=')
+        ++position;
+    
+    return String(CharPointer_UTF8(start), CharPointer_UTF8(position));
+}
+
+SvgScanner::Token SvgScanner::next()
+{
+    element.reset();
+    emptyElement = false;
+    
+    while (true)
+    {
+        // Text between tags is never drawn
+        while (position < end && *position != '<')
+            ++position;
+        
+        if (position >= end)
+            return Token::end;
+        
+        const auto remaining = (size_t) (end - position);
+        auto startsWith = [&](const char* text) {
+            const size_t length = std::strlen(text);
+            return remaining >= length && std::memcmp(position, text, length) == 0;
+        };
+        
+        bool skipped = true;
+        
+        if (startsWith("<!--"))
+            skipped = skipPast("-->");
+        else if (startsWith("<![CDATA["))
+            skipped = skipPast("]]>");
+        else if (startsWith("<?"))
+            skipped = skipPast("?>");
+        else if (startsWith("<!"))
+            skipped = skipDoctype();
+        else if (startsWith("</"))
+            return readEndTag();
+        else
+            return readStartTag();
+        
+        if (!skipped)
+            return Token::error;
+    }
+}
+
+SvgScanner::Token SvgScanner::readEndTag()
+{
+    position += 2;
+    tagName = readName();
+    skipWhitespace();
+    
+    if (tagName.isEmpty() || position >= end || *position != '>')
+        return Token::error;
+    
+    ++position;
+    return Token::endTag;
+}
+
+SvgScanner::Token SvgScanner::readStartTag()
+{
+    ++position;
+    tagName = readName();
+    
+    if (tagName.isEmpty())
+        return Token::error;
+    
+    element = std::make_unique<XmlElement>(tagName);
+    
+    while (true)
+    {
+        skipWhitespace();
+        
+        if (position >= end)
+            return Token::error;
+        
+        if (*position == '>')
+        {
+            ++position;
+            return Token::startTag;
+        }
+        
+        if (*position == '/')
+        {
+            if (++position >= end || *position != '>')
+                return Token::error;
+            
+            ++position;
+            emptyElement = true;
+            return Token::startTag;
+        }
+        
+        auto name = readName();
+        skipWhitespace();
+        
+        if (name.isEmpty() || position >= end || *position != '=')
+            return Token::error;
+        
+        ++position;
+        skipWhitespace();
+        
+        if (position >= end || (*position != '"' && *position != '\''))
+            return Token::error;
+        
+        const char quote = *position++;
+        const char* valueStart = position;
+        
+        while (position < end && *position != quote)
+            ++position;
+        
+        if (position >= end)
+            return Token::error;
+        
+        // Most values have no references, so they are copied as they are
+        const bool hasEntities = std::memchr(valueStart, '&', (size_t) (position - valueStart)) != nullptr;
+        element->setAttribute(name, hasEntities ? decodeEntities(valueStart, position)
+                                                : String(CharPointer_UTF8(valueStart), CharPointer_UTF8(position)));
+        ++position;
+    }
+}
+
+String SvgScanner::decodeEntities(const char* start, const char* end)
+{
+    String result;
+    const char* run = start;
+    
+    for (const char* p = start; p < end; ++p)
+    {
+        if (*p != '&')
+            continue;
+        
+        const char* semicolon = p + 1;
+        while (semicolon < end && *semicolon != ';' && semicolon - p < 12)
+            ++semicolon;
+        
+        if (semicolon >= end || *semicolon != ';')
+            continue;
+        
+        const String name(CharPointer_UTF8(p + 1), CharPointer_UTF8(semicolon));
+        juce_wchar character = 0;
+        
+        if (name == "amp")
+            character = '&';
+        else if (name == "lt")
+            character = '<';
+        else if (name == "gt")
+            character = '>';
+        else if (name == "quot")
+            character = '"';
+        else if (name == "apos")
+            character = '\'';
+        else if (name.startsWith("#x"))
+            character = (juce_wchar) name.substring(2).getHexValue32();
+        else if (name.startsWithChar('#'))
+            character = (juce_wchar) name.substring(1).getIntValue();
+        
+        // Unknown references are kept as they are written
+        if (character == 0)
+            continue;
+        
+        result << String(CharPointer_UTF8(run), CharPointer_UTF8(p)) << String::charToString(character);
+        run = semicolon + 1;
+        p = semicolon;
+    }
+    
+    result << String(CharPointer_UTF8(run), CharPointer_UTF8(end));
+    return result;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreIncludes.h"
+
+//! @brief reads the tags of an svg straight from its utf-8 bytes, without building an xml tree
+//! Text, comments, CDATA sections, processing instructions and the doctype are skipped, since
+//! SvgParser only reads elements and their attributes. Each start tag becomes an XmlElement that
+//! holds just its attributes, which the caller can keep or drop as it goes.
+class SvgScanner
+{
+public:
+    enum class Token
+    {
+        startTag, // an element opens, or opens and closes if isEmptyElement()
+        endTag,   // an element closes
+        end,      // the data ended after the last tag
+        error     // the data is not well-formed enough to read on
+    };
+    
+    //! @arg data: the svg's bytes, which must stay valid while scanning
+    //! @arg size: the size of the data in bytes
+    SvgScanner(const void* data, size_t size);
+    ~SvgScanner() {};
+    
+    //! @brief reads up to the end of the next tag
+    Token next();
+    
+    //! @brief returns the name of the tag just read
+    const String& getTagName() const { return tagName; }
+    //! @brief returns true if the start tag just read was closed with />
+    bool isEmptyElement() const { return emptyElement; }
+    //! @brief hands over the element of the start tag just read, with its attributes
+    std::unique_ptr<XmlElement> takeElement() { return std::move(element); }
+    
+    //! @brief replaces the predefined and numeric character references in some text
+    static String decodeEntities(const char* start, const char* end);
+    
+private:
+    bool skipPast(const char* terminator);
+    bool skipDoctype();
+    void skipWhitespace();
+    String readName();
+    Token readStartTag();
+    Token readEndTag();
+    
+    const char* position;
+    const char* const end;
+    String tagName;
+    std::unique_ptr<XmlElement> element;
+    bool emptyElement{false};
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SvgScanner)
+};
@@ -0,0 +1,105 @@
+#include "Tracing.h"
+#include <atomic>
+
+//==============================================================================
+//! @brief the events of one thread, appended to without locking
+struct ThreadTrace
+{
+    struct Event
+    {
+        const char* name;
+        int64 startTicks;
+        int64 endTicks;
+    };
+    
+    int id;
+    String name;
+    std::vector<Event> events;
+};
+
+static std::atomic<bool> recording{false};
+static std::atomic<int64> traceStartTicks{0};
+
+// Threads are only added under the lock, and never removed, so each thread can keep a pointer to its own
+static CriticalSection threadsLock;
+static std::vector<std::unique_ptr<ThreadTrace>> threadTraces;
+static thread_local ThreadTrace* currentThreadTrace = nullptr;
+
+void Tracing::start()
+{
+    const ScopedLock lock(threadsLock);
+    
+    for (auto& trace: threadTraces)
+        trace->events.clear();
+    
+    traceStartTicks = Time::getHighResolutionTicks();
+    recording = true;
+}
+
+void Tracing::stop()
+{
+    recording = false;
+}
+
+bool Tracing::isRecording()
+{
+    return recording.load(std::memory_order_relaxed);
+}
+
+void Tracing::record(const char* name, int64 startTicks, int64 endTicks)
+{
+    if (currentThreadTrace == nullptr)
+    {
+        const ScopedLock lock(threadsLock);
+        
+        auto trace = std::make_unique<ThreadTrace>();
+        trace->id = (int) threadTraces.size() + 1;
+        
+        if (auto* thread = Thread::getCurrentThread())
+            trace->name = thread->getThreadName();
+        else
+            trace->name = trace->id == 1 ? "main" : "thread " + String(trace->id);
+        
+        currentThreadTrace = trace.get();
+        threadTraces.push_back(std::move(trace));
+    }
+    
+    currentThreadTrace->events.push_back({name, startTicks, endTicks});
+}
+
+String Tracing::getChromeTrace()
+{
+    const ScopedLock lock(threadsLock);
+    
+    auto toMicroseconds = [](int64 ticks) {
+        return String(Time::highResolutionTicksToSeconds(ticks - traceStartTicks.load()) * 1.0e6, 3);
+    };
+    
+    // Complete events ("ph": "X") carry their duration, so one event covers a whole span
+    MemoryOutputStream out;
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    
+    for (const auto& trace: threadTraces)
+    {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << trace->id
+            << ",\"args\":{\"name\":\"" << JSON::escapeString(trace->name) << "\"}}";
+        first = false;
+        
+        for (const auto& event: trace->events)
+        {
+            out << ",\n{\"name\":\"" << JSON::escapeString(event.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << trace->id
+                << ",\"ts\":" << toMicroseconds(event.startTicks)
+                << ",\"dur\":" << String(Time::highResolutionTicksToSeconds(event.endTicks - event.startTicks) * 1.0e6, 3)
+                << "}";
+        }
+    }
+    
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return out.toString();
+}
+
+bool Tracing::writeChromeTrace(const File& file)
+{
+    return file.replaceWithText(getChromeTrace());
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreIncludes.h"
+#include "AllocationStats.h"
+
+#ifndef SVG2PATH_TRACING
+ #define SVG2PATH_TRACING 0
+#endif
+
+//! @brief scoped spans recorded per thread, written out as Chrome trace-event JSON
+//! Spans compile to nothing unless SVG2PATH_TRACING is 1. Compiled in, a span costs an atomic
+//! load while nothing is recording, and two clock reads and an append to its thread's own
+//! buffer while something is. Open the trace in chrome://tracing or ui.perfetto.dev. Builds with
+//! SVG2PATH_ALLOCATION_STATS also use the spans as the stages allocations are counted under.
+class Tracing
+{
+public:
+    //! @brief clears the events recorded so far and starts recording
+    static void start();
+    //! @brief stops recording, the events are kept until the next start
+    static void stop();
+    static bool isRecording();
+    //! @brief returns the recorded events as trace-event JSON
+    //! Threads must have finished their spans, so call this once the work being traced is done.
+    static String getChromeTrace();
+    //! @brief writes the recorded events to a file as trace-event JSON
+    static bool writeChromeTrace(const File& file);
+    
+    //! @brief records the time from its construction to its destruction, use SVG2PATH_TRACE_SCOPE
+    class ScopedSpan
+    {
+    public:
+        //! @arg name: a string literal, only the pointer is kept
+        explicit ScopedSpan(const char* name) : name(name), startTicks(isRecording() ? Time::getHighResolutionTicks() : 0) {}
+        ~ScopedSpan()
+        {
+            if (startTicks != 0)
+                record(name, startTicks, Time::getHighResolutionTicks());
+        }
+        
+    private:
+        const char* name;
+        int64 startTicks;
+
+#if SVG2PATH_ALLOCATION_STATS
+        AllocationStats::ScopedStage stage{name};
+#endif
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedSpan)
+    };
+    
+private:
+    static void record(const char* name, int64 startTicks, int64 endTicks);
+};
+
+#if SVG2PATH_TRACING || SVG2PATH_ALLOCATION_STATS
+ #define SVG2PATH_TRACE_SCOPE(name) Tracing::ScopedSpan JUCE_JOIN_MACRO(traceSpan, __LINE__)(name)
+#else
+ #define SVG2PATH_TRACE_SCOPE(name)
+#endif
@@ -0,0 +1,263 @@
+/*
+  ==============================================================================
+
+    Checks the cubic approximation of svg arcs against the analytic ellipses
+    they approximate.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SvgParser.h"
+
+//==============================================================================
+class ArcTests: public UnitTest
+{
+public:
+    ArcTests() : UnitTest("Arc approximation", "Svg2Path") {}
+    
+    void runTest() override
+    {
+        testSegmentCounts();
+        testDeviation();
+        testDegenerateArcs();
+    }
+    
+private:
+    //! @brief an arc given by its centre parameterisation
+    struct Ellipse
+    {
+        double cx, cy, rx, ry, rotation; // rotation in degrees
+        
+        Point<double> getPoint(double angle) const
+        {
+            const double phi = degreesToRadians(rotation);
+            const double u = rx * std::cos(angle), v = ry * std::sin(angle);
+            return {cx + u * std::cos(phi) - v * std::sin(phi), cy + u * std::sin(phi) + v * std::cos(phi)};
+        }
+        
+        //! @brief the distance of a point from the ellipse along its radius, scaled by the larger radius,
+        //! which is the error the segment count bounds
+        double getRadialError(Point<double> p) const
+        {
+            const double phi = degreesToRadians(rotation);
+            const double dx = p.x - cx, dy = p.y - cy;
+            const double u = (dx * std::cos(phi) + dy * std::sin(phi)) / rx;
+            const double v = (-dx * std::sin(phi) + dy * std::cos(phi)) / ry;
+            return std::abs(std::sqrt(u * u + v * v) - 1.0) * jmax(rx, ry);
+        }
+    };
+    
+    //! @brief the largest radial error of a cubic of n equal segments approximating a circular arc
+    static double getErrorBound(double radius, double sweepAngle, int numSegments)
+    {
+        const double quarter = std::abs(sweepAngle) / (4.0 * numSegments);
+        return radius * 2.0 / 27.0 * std::pow(std::sin(quarter), 6.0) / std::pow(std::cos(quarter), 2.0);
+    }
+    
+    //! @brief the elements of a shape's path, for checking what an arc emitted
+    static Array<Path::Iterator::PathElementType> getElementTypes(const ShapeData& shape, Point<float>& end)
+    {
+        Path path;
+        shape.appendTo(path);
+        
+        Array<Path::Iterator::PathElementType> types;
+        for (Path::Iterator it(path); it.next();)
+        {
+            types.add(it.elementType);
+            
+            if (it.elementType == Path::Iterator::lineTo)
+                end = {it.x1, it.y1};
+            else if (it.elementType == Path::Iterator::cubicTo)
+                end = {it.x3, it.y3};
+        }
+        
+        return types;
+    }
+    
+    //! @brief samples every cubic of a shape and returns the largest radial error from an ellipse
+    static double getMaxRadialError(const ShapeData& shape, const Ellipse& ellipse, int& numCubics)
+    {
+        Path path;
+        shape.appendTo(path);
+        
+        double maxError = 0.0;
+        Point<double> last;
+        numCubics = 0;
+        
+        for (Path::Iterator it(path); it.next();)
+        {
+            if (it.elementType == Path::Iterator::startNewSubPath)
+            {
+                last = {it.x1, it.y1};
+                continue;
+            }
+            
+            if (it.elementType != Path::Iterator::cubicTo)
+                continue;
+            
+            const Point<double> p1(it.x1, it.y1), p2(it.x2, it.y2), p3(it.x3, it.y3);
+            
+            for (int i = 0; i <= 64; ++i)
+            {
+                const double t = i / 64.0, mt = 1.0 - t;
+                const auto p = last * (mt * mt * mt) + p1 * (3.0 * mt * mt * t) + p2 * (3.0 * mt * t * t) + p3 * (t * t * t);
+                maxError = jmax(maxError, ellipse.getRadialError(p));
+            }
+            
+            last = p3;
+            ++numCubics;
+        }
+        
+        return maxError;
+    }
+    
+    void testSegmentCounts()
+    {
+        beginTest("Segment counts are the fewest within the error bound");
+        
+        const double pi = MathConstants<double>::pi;
+        
+        for (double radius: {0.5, 1.0, 24.0, 200.0, 1000.0})
+        {
+            for (double sweep: {0.1, 1.0, pi * 0.5, pi, pi * 1.5, pi * 2.0, -pi * 1.5})
+            {
+                for (float maxError: {0.1f, 0.01f, 0.001f})
+                {
+                    const int n = SvgParser::getNumArcSegments(radius, sweep, maxError);
+                    const int minSegments = jmax(1, (int) std::ceil(std::abs(sweep) / pi - 1.0e-9));
+                    
+                    // No segment may sweep more than half a turn
+                    expectGreaterOrEqual(n, minSegments);
+                    
+                    if (n < SvgParser::maxArcSegments)
+                        expectLessOrEqual(getErrorBound(radius, sweep, n), (double) maxError);
+                    
+                    if (n > minSegments)
+                        expectGreaterThan(getErrorBound(radius, sweep, n - 1), (double) maxError);
+                }
+            }
+        }
+        
+        expectEquals(SvgParser::getNumArcSegments(1.0, pi * 0.5, 0.01f), 1);
+        expectEquals(SvgParser::getNumArcSegments(100.0, pi * 2.0, 0.01f), 5);
+        expectEquals(SvgParser::getNumArcSegments(100.0, pi * 2.0, 0.001f), 7);
+        expectEquals(SvgParser::getNumArcSegments(1.0e9, pi * 2.0, 1.0e-4f), SvgParser::maxArcSegments);
+    }
+    
+    void testDeviation()
+    {
+        beginTest("Arcs stay within the error bound of the analytic ellipse");
+        
+        const double pi = MathConstants<double>::pi;
+        
+        for (double radius: {1.0, 24.0, 200.0})
+        {
+            for (double aspect: {1.0, 0.4})
+            {
+                for (double rotation: {0.0, 30.0, -75.0})
+                {
+                    for (double sweep: {0.3, 1.0, pi * 0.5, 2.5, 4.0, 5.5, -2.0, -pi * 2.0 + 0.5})
+                    {
+                        for (float maxError: {0.1f, 0.01f})
+                        {
+                            const Ellipse ellipse{10.0, -5.0, radius, radius * aspect, rotation};
+                            const double startAngle = 0.7;
+                            const auto start = ellipse.getPoint(startAngle).toFloat();
+                            const auto end = ellipse.getPoint(startAngle + sweep).toFloat();
+                            
+                            SvgParser parser;
+                            parser.setMaxArcError(maxError);
+                            
+                            ShapeData shape;
+                            shape.startNewSubPath(start.x, start.y);
+                            parser.addArc(start.x, start.y, (float) ellipse.rx, (float) ellipse.ry, (float) rotation,
+                                          std::abs(sweep) > pi, sweep > 0.0, end.x, end.y, shape);
+                            
+                            int numCubics = 0;
+                            const double error = getMaxRadialError(shape, ellipse, numCubics);
+                            
+                            // Coordinates are floats, so allow for their rounding on top of the bound
+                            const double rounding = 4.0e-6 * (radius + 20.0);
+                            expectLessOrEqual(error, maxError + rounding,
+                                              "radius " + String(radius) + ", aspect " + String(aspect) + ", rotation "
+                                                  + String(rotation) + ", sweep " + String(sweep));
+                            expectEquals(numCubics, SvgParser::getNumArcSegments(radius, sweep, maxError));
+                            
+                            Point<float> last;
+                            getElementTypes(shape, last);
+                            expect(last == end, "the arc ends on its endpoint");
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    void testDegenerateArcs()
+    {
+        beginTest("Degenerate arcs");
+        
+        SvgParser parser;
+        
+        // A zero radius draws a straight line to the endpoint
+        for (auto radii: {Point<float>(0.0f, 5.0f), Point<float>(5.0f, 0.0f), Point<float>()})
+        {
+            ShapeData shape;
+            shape.startNewSubPath(0.0f, 0.0f);
+            parser.addArc(0.0f, 0.0f, radii.x, radii.y, 0.0f, false, true, 10.0f, 10.0f, shape);
+            
+            Point<float> end;
+            const auto types = getElementTypes(shape, end);
+            expectEquals(types.size(), 2);
+            expect(types[1] == Path::Iterator::lineTo, "a zero radius arc is a line");
+            expect(end == Point<float>(10.0f, 10.0f));
+        }
+        
+        // An arc that ends where it starts draws nothing
+        {
+            ShapeData shape;
+            shape.startNewSubPath(5.0f, 5.0f);
+            parser.addArc(5.0f, 5.0f, 10.0f, 10.0f, 0.0f, true, true, 5.0f, 5.0f, shape);
+            
+            Point<float> end;
+            expectEquals(getElementTypes(shape, end).size(), 1);
+        }
+        
+        // Radii too small to span the endpoints are scaled up until they just do, centred between them
+        {
+            ShapeData shape;
+            shape.startNewSubPath(0.0f, 0.0f);
+            parser.addArc(0.0f, 0.0f, 1.0f, 1.0f, 0.0f, false, true, 10.0f, 0.0f, shape);
+            
+            int numCubics = 0;
+            expectLessOrEqual(getMaxRadialError(shape, {5.0, 0.0, 5.0, 5.0, 0.0}, numCubics), 0.01 + 1.0e-4);
+            expectEquals(numCubics, SvgParser::getNumArcSegments(5.0, MathConstants<double>::pi, 0.01f));
+        }
+        
+        {
+            ShapeData shape;
+            shape.startNewSubPath(0.0f, 0.0f);
+            parser.addArc(0.0f, 0.0f, 2.0f, 1.0f, 0.0f, false, false, 0.0f, 10.0f, shape);
+            
+            int numCubics = 0;
+            expectLessOrEqual(getMaxRadialError(shape, {0.0, 5.0, 10.0, 5.0, 0.0}, numCubics), 0.01 + 1.0e-4);
+        }
+        
+        // Negative radii are used as their absolute values
+        {
+            ShapeData positive, negative;
+            positive.startNewSubPath(0.0f, 0.0f);
+            negative.startNewSubPath(0.0f, 0.0f);
+            parser.addArc(0.0f, 0.0f, 8.0f, 4.0f, 20.0f, true, false, 6.0f, 3.0f, positive);
+            parser.addArc(0.0f, 0.0f, -8.0f, -4.0f, 20.0f, true, false, 6.0f, 3.0f, negative);
+            
+            Path a, b;
+            positive.appendTo(a);
+            negative.appendTo(b);
+            expectEquals(b.toString(), a.toString());
+        }
+    }
+};
+
+static ArcTests arcTests;
@@ -0,0 +1,235 @@
+/*
+  ==============================================================================
+
+    Checks that AssetPack reads what AssetPackWriter wrote, and rejects packs
+    that are truncated, corrupt or point outside their data without reading
+    out of bounds.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AssetPackWriter.h"
+
+//==============================================================================
+class AssetPackTests: public UnitTest
+{
+public:
+    AssetPackTests() : UnitTest("Asset packs", "Svg2Path") {}
+    
+    void runTest() override
+    {
+        testRoundTrip();
+        testTruncated();
+        testBadChecksums();
+        testOutOfRangeOffsets();
+        testMisaligned();
+    }
+    
+private:
+    static constexpr int numAssets = 3;
+    
+    static MemoryBlock buildPack()
+    {
+        AssetPackWriter writer;
+        
+        ShapeData rectangle;
+        rectangle.addRectangle(0.0f, 0.0f, 4.0f, 2.0f);
+        writer.addAsset("rectangle", rectangle);
+        
+        ShapeData ellipse;
+        ellipse.addEllipse(1.0f, 1.0f, 6.0f, 3.0f);
+        writer.addAsset("ellipse", ellipse);
+        
+        ShapeData curve;
+        curve.startNewSubPath(0.0f, 0.0f);
+        curve.cubicTo(2.0f, 5.0f, 6.0f, 5.0f, 8.0f, 0.0f);
+        curve.closeSubPath();
+        writer.addAsset("curve", curve);
+        
+        return writer.build();
+    }
+    
+    static uint8* at(MemoryBlock& block, size_t offset)
+    {
+        return static_cast<uint8*>(block.getData()) + offset;
+    }
+    
+    static void put32(MemoryBlock& block, size_t offset, uint32 value)
+    {
+        for (int i = 0; i < 4; ++i)
+            at(block, offset)[i] = (uint8) (value >> (8 * i));
+    }
+    
+    static void put64(MemoryBlock& block, size_t offset, uint64 value)
+    {
+        for (int i = 0; i < 8; ++i)
+            at(block, offset)[i] = (uint8) (value >> (8 * i));
+    }
+    
+    //! @brief rewrites the index and header checksums, so only the structural checks can reject an edit
+    static void reseal(MemoryBlock& block)
+    {
+        const auto indexOffset = (size_t) ByteOrder::littleEndianInt64(at(block, 24));
+        const auto dataOffset = (size_t) ByteOrder::littleEndianInt64(at(block, 40));
+        
+        if (indexOffset <= dataOffset && dataOffset <= block.getSize())
+            put32(block, 48, AssetPack::checksum(at(block, indexOffset), dataOffset - indexOffset));
+        
+        put32(block, 52, AssetPack::checksum(block.getData(), 52));
+    }
+    
+    static size_t getEntryOffset(int index)
+    {
+        return AssetPack::headerSize + (size_t) index * AssetPack::indexEntrySize;
+    }
+    
+    //! @brief checks that a pack opens and every asset decodes to the same path as the original
+    void expectSamePaths(const AssetPack& pack, const AssetPack& original)
+    {
+        expect(pack.isValid());
+        expect(pack.verify());
+        expectEquals(pack.getNumEntries(), numAssets);
+        
+        for (const auto* name: {"rectangle", "ellipse", "curve"})
+        {
+            const auto path = pack.getPath(name);
+            expect(!path.isEmpty(), name);
+            expect(path.getBounds() == original.getPath(name).getBounds(), name);
+        }
+    }
+    
+    void testRoundTrip()
+    {
+        beginTest("Round trip");
+        
+        const auto data = buildPack();
+        const AssetPack pack(data.getData(), data.getSize());
+        expectSamePaths(pack, pack);
+        
+        expect(pack.getPath("rectangle").getBounds() == Rectangle<float>(0.0f, 0.0f, 4.0f, 2.0f));
+        expect(pack.getPath("missing").isEmpty());
+    }
+    
+    void testTruncated()
+    {
+        beginTest("Truncated packs are rejected");
+        
+        const auto data = buildPack();
+        
+        // Every length short of the whole file, copied so reading past the end would be caught
+        for (size_t size = 0; size < data.getSize(); ++size)
+        {
+            MemoryBlock truncated(data.getData(), size);
+            const AssetPack pack(truncated.getData(), truncated.getSize());
+            expect(!pack.isValid(), "truncated to " + String((int) size));
+            expectEquals(pack.getNumEntries(), 0);
+            expect(pack.getPath("rectangle").isEmpty());
+        }
+        
+        // A file size in the header that the data doesn't have
+        MemoryBlock extended(data);
+        extended.append("\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 16);
+        expect(!AssetPack(extended.getData(), extended.getSize()).isValid());
+    }
+    
+    void testBadChecksums()
+    {
+        beginTest("Bad checksums");
+        
+        const auto data = buildPack();
+        const AssetPack original(data.getData(), data.getSize());
+        
+        // A flipped bit in the header, the index or a name fails the checks on opening
+        const auto dataOffset = (size_t) ByteOrder::littleEndianInt64(static_cast<const uint8*>(data.getData()) + 40);
+        
+        for (size_t offset: {(size_t) 8, (size_t) 12, getEntryOffset(1) + 12, dataOffset - 1})
+        {
+            MemoryBlock corrupt(data);
+            at(corrupt, offset)[0] ^= 0x10;
+            expect(!AssetPack(corrupt.getData(), corrupt.getSize()).isValid(), "byte " + String((int) offset));
+        }
+        
+        // A flipped bit in one asset's data only fails that asset, when it is decoded
+        const int index = original.indexOf("curve");
+        const auto entryData = (size_t) ByteOrder::littleEndianInt64(static_cast<const uint8*>(data.getData())
+                                                                     + getEntryOffset(index) + 16);
+        MemoryBlock corrupt(data);
+        at(corrupt, entryData)[0] ^= 0x10;
+        
+        const AssetPack pack(corrupt.getData(), corrupt.getSize());
+        expect(pack.isValid());
+        expect(!pack.verify());
+        
+        Path path;
+        expect(!pack.getPath(index, path));
+        expect(path.isEmpty());
+        expect(!pack.getPath("rectangle").isEmpty());
+        expect(!pack.getPath("ellipse").isEmpty());
+    }
+    
+    void testOutOfRangeOffsets()
+    {
+        beginTest("Offsets outside the data are rejected");
+        
+        const auto data = buildPack();
+        const uint64 fileSize = data.getSize();
+        const auto dataOffset = ByteOrder::littleEndianInt64(static_cast<const uint8*>(data.getData()) + 40);
+        
+        // Each edit is resealed, so it is the bounds checks that have to catch it
+        auto expectRejected = [&](const String& name, const std::function<void(MemoryBlock&)>& edit) {
+            MemoryBlock corrupt(data);
+            edit(corrupt);
+            reseal(corrupt);
+            
+            const AssetPack pack(corrupt.getData(), corrupt.getSize());
+            expect(!pack.isValid(), name);
+            expectEquals(pack.indexOf("rectangle"), -1, name);
+        };
+        
+        // An entry's shape data past the end, wrapping around, before the data section or unaligned
+        for (uint64 value: {fileSize, fileSize + 16, ~(uint64) 15, dataOffset - 16, dataOffset + 4})
+        {
+            expectRejected("data offset " + String((int64) value),
+                           [&](MemoryBlock& b) { put64(b, getEntryOffset(0) + 16, value); });
+        }
+        
+        // Counts that run an entry's data past the end
+        expectRejected("coords", [&](MemoryBlock& b) { put32(b, getEntryOffset(2) + 24, 0x40000000u); });
+        expectRejected("verbs", [&](MemoryBlock& b) { put32(b, getEntryOffset(2) + 12, 0xffffffffu); });
+        
+        // A name past the strings
+        expectRejected("name offset", [&](MemoryBlock& b) { put32(b, getEntryOffset(0) + 4, 0xffffff00u); });
+        expectRejected("name length", [&](MemoryBlock& b) { put32(b, getEntryOffset(0) + 8, (uint32) fileSize); });
+        
+        // Sections that overlap the header, run past the end or wrap around
+        expectRejected("index offset", [&](MemoryBlock& b) { put64(b, 24, 16); });
+        expectRejected("wrapped index offset", [&](MemoryBlock& b) {
+            // Three entries past this offset wrap around to 64, where the names are moved to
+            put64(b, 24, ~(uint64) 0 - 95 + 64);
+            put64(b, 32, 64);
+        });
+        expectRejected("data section", [&](MemoryBlock& b) { put64(b, 40, fileSize + 16); });
+        expectRejected("entry count", [&](MemoryBlock& b) { put32(b, 8, 0x10000000u); });
+    }
+    
+    void testMisaligned()
+    {
+        beginTest("Packs at unaligned addresses");
+        
+        const auto data = buildPack();
+        const AssetPack original(data.getData(), data.getSize());
+        
+        // The floats can't be used in place, so they are copied out
+        for (size_t shift = 1; shift < 4; ++shift)
+        {
+            MemoryBlock shifted(data.getSize() + shift, true);
+            shifted.copyFrom(data.getData(), (int) shift, data.getSize());
+            
+            const AssetPack pack(at(shifted, shift), data.getSize());
+            expectSamePaths(pack, original);
+        }
+    }
+};
+
+static AssetPackTests assetPackTests;
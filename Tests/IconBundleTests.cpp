@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    Checks that IconBundle finds what IconBundleWriter packed, and rejects
+    bundles whose tables point outside the data.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "IconBundleWriter.h"
+
+//==============================================================================
+class IconBundleTests: public UnitTest
+{
+public:
+    IconBundleTests() : UnitTest("Icon bundles", "Svg2Path") {}
+    
+    void runTest() override
+    {
+        testLookup();
+        testCorruptSlots();
+    }
+    
+private:
+    static MemoryBlock buildBundle()
+    {
+        IconBundleWriter writer;
+        
+        for (int i = 0; i < 5; ++i)
+        {
+            Path path;
+            path.addRectangle(0.0f, 0.0f, (float) i + 1.0f, 1.0f);
+            writer.addIcon("icon" + String(i), path);
+        }
+        
+        return writer.build();
+    }
+    
+    void testLookup()
+    {
+        beginTest("Lookup");
+        
+        const auto data = buildBundle();
+        const IconBundle bundle(data.getData(), data.getSize());
+        expect(bundle.isValid());
+        expectEquals(bundle.getNumIcons(), 5);
+        
+        for (int i = 0; i < 5; ++i)
+        {
+            const String name = "icon" + String(i);
+            const int index = bundle.indexOf(name);
+            expectEquals(bundle.getName(index), name);
+            expectEquals(bundle.getPath(name).getBounds().getWidth(), (float) i + 1.0f);
+        }
+        
+        expectEquals(bundle.indexOf("missing"), -1);
+        expect(bundle.getPath("missing").isEmpty());
+    }
+    
+    void testCorruptSlots()
+    {
+        beginTest("Slots naming entries past the table are rejected");
+        
+        const auto data = buildBundle();
+        const IconBundle original(data.getData(), data.getSize());
+        const auto* bytes = static_cast<const uint8*>(data.getData());
+        const uint32 numSlots = ByteOrder::littleEndianInt(bytes + 12);
+        
+        for (uint32 slot = 0; slot < numSlots; ++slot)
+        {
+            const size_t offset = IconBundle::headerSize + slot * 4;
+            if (ByteOrder::littleEndianInt(bytes + offset) == 0)
+                continue;
+            
+            // One past the last entry, and one far outside the data
+            for (uint32 value: {(uint32) original.getNumIcons() + 1, 0x7fffffffu})
+            {
+                MemoryBlock corrupt(data);
+                auto* slotBytes = static_cast<uint8*>(corrupt.getData()) + offset;
+                for (int i = 0; i < 4; ++i)
+                    slotBytes[i] = (uint8) (value >> (8 * i));
+                
+                const IconBundle bundle(corrupt.getData(), corrupt.getSize());
+                expect(!bundle.isValid());
+                expectEquals(bundle.indexOf("icon0"), -1);
+            }
+            
+            break;
+        }
+    }
+};
+
+static IconBundleTests iconBundleTests;
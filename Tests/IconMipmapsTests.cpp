@@ -0,0 +1,221 @@
+/*
+  ==============================================================================
+
+    Checks that IconMipmaps reads the masks IconMipmapWriter baked, rejects
+    tables that are truncated or point outside their data, and falls back to
+    the path when a mask doesn't decode.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "IconMipmapWriter.h"
+
+//==============================================================================
+class IconMipmapsTests: public UnitTest
+{
+public:
+    IconMipmapsTests() : UnitTest("Icon mipmaps", "Svg2Path") {}
+    
+    void runTest() override
+    {
+        testRoundTrip();
+        testTruncated();
+        testOutOfRangeEntries();
+        testCorruptMasks();
+        testMisaligned();
+    }
+    
+private:
+    static Path getCircle()
+    {
+        Path circle;
+        circle.addEllipse(0.1f, 0.1f, 0.8f, 0.8f);
+        return circle;
+    }
+    
+    static MemoryBlock buildMips()
+    {
+        return IconMipmapWriter({16, 24}, {1.0f}).build(getCircle());
+    }
+    
+    static void put32(MemoryBlock& block, size_t offset, uint32 value)
+    {
+        for (int i = 0; i < 4; ++i)
+            block[(int) (offset + (size_t) i)] = (char) (value >> (8 * i));
+    }
+    
+    static size_t getEntryOffset(int index)
+    {
+        return IconMipmaps::headerSize + (size_t) index * IconMipmaps::mipEntrySize;
+    }
+    
+    static bool isSameImage(const Image& a, const Image& b)
+    {
+        if (a.isNull() || b.isNull() || a.getBounds() != b.getBounds())
+            return false;
+        
+        const Image::BitmapData first(a, Image::BitmapData::readOnly);
+        const Image::BitmapData second(b, Image::BitmapData::readOnly);
+        
+        for (int y = 0; y < first.height; ++y)
+            for (int x = 0; x < first.width; ++x)
+                if (first.getPixelPointer(x, y)[0] != second.getPixelPointer(x, y)[0])
+                    return false;
+        
+        return true;
+    }
+    
+    //! @brief the number of pixels drawn into, to tell a fallback fill from nothing drawn
+    static int countCoveredPixels(const Image& image)
+    {
+        const Image::BitmapData bitmap(image, Image::BitmapData::readOnly);
+        int covered = 0;
+        
+        for (int y = 0; y < bitmap.height; ++y)
+            for (int x = 0; x < bitmap.width; ++x)
+                covered += bitmap.getPixelColour(x, y).getAlpha() > 0 ? 1 : 0;
+        
+        return covered;
+    }
+    
+    void testRoundTrip()
+    {
+        beginTest("Round trip");
+        
+        const auto data = buildMips();
+        const IconMipmaps mips(data.getData(), data.getSize());
+        expect(mips.isValid());
+        expectEquals(mips.getNumMips(), 2);
+        
+        for (int size: {16, 24})
+        {
+            const int index = mips.findMip(size);
+            expectEquals(mips.getPixelSize(index), size);
+            expect(isSameImage(mips.getMip(index), IconMipmapWriter::rasterise(getCircle(), size)));
+        }
+        
+        expectEquals(mips.findMip(32), -1);
+    }
+    
+    void testTruncated()
+    {
+        beginTest("Truncated tables are rejected");
+        
+        const auto data = buildMips();
+        
+        // The last mask ends the data, so any cut leaves an entry pointing past the end
+        for (size_t size = 0; size < data.getSize(); ++size)
+        {
+            MemoryBlock truncated(data.getData(), size);
+            const IconMipmaps mips(truncated.getData(), truncated.getSize());
+            expect(!mips.isValid(), "truncated to " + String((int) size));
+            expectEquals(mips.getNumMips(), 0);
+            expect(mips.getMip(0).isNull());
+        }
+    }
+    
+    void testOutOfRangeEntries()
+    {
+        beginTest("Entries outside the data are rejected");
+        
+        const auto data = buildMips();
+        
+        auto expectRejected = [&](const String& name, const std::function<void(MemoryBlock&)>& edit) {
+            MemoryBlock corrupt(data);
+            edit(corrupt);
+            expect(!IconMipmaps(corrupt.getData(), corrupt.getSize()).isValid(), name);
+        };
+        
+        // Offsets and lengths past the end, including ones whose sum wraps a 32 bit size
+        expectRejected("offset", [](MemoryBlock& b) { put32(b, getEntryOffset(1) + 4, (uint32) b.getSize()); });
+        expectRejected("length", [](MemoryBlock& b) { put32(b, getEntryOffset(0) + 8, (uint32) b.getSize()); });
+        expectRejected("wrapped", [](MemoryBlock& b) {
+            put32(b, getEntryOffset(0) + 4, 0xfffffff0u);
+            put32(b, getEntryOffset(0) + 8, 0x20u);
+        });
+        
+        // More entries than the data holds, and a mip with no pixels
+        expectRejected("count", [](MemoryBlock& b) { b[6] = (char) 0xff; b[7] = (char) 0xff; });
+        expectRejected("size", [](MemoryBlock& b) { put32(b, getEntryOffset(0), 0); });
+        
+        // A different magic or version
+        expectRejected("magic", [](MemoryBlock& b) { b[0] = 0; });
+        expectRejected("version", [](MemoryBlock& b) { b[4] = 2; });
+    }
+    
+    void testCorruptMasks()
+    {
+        beginTest("Masks that don't decode fall back to the path");
+        
+        const auto data = buildMips();
+        
+        // A stream one byte short can't fill its mask
+        {
+            MemoryBlock corrupt(data);
+            const auto* bytes = static_cast<const uint8*>(data.getData());
+            const auto length = ByteOrder::littleEndianInt(bytes + getEntryOffset(0) + 8);
+            put32(corrupt, getEntryOffset(0) + 8, length - 1);
+            
+            const IconMipmaps mips(corrupt.getData(), corrupt.getSize(), getCircle());
+            expect(mips.isValid());
+            expect(mips.getMip(0).isNull());
+            expect(isSameImage(mips.getMip(1), IconMipmapWriter::rasterise(getCircle(), 24)));
+            
+            // The mask is missing, so the icon is filled from its path instead
+            Image image(Image::ARGB, 16, 16, true, SoftwareImageType());
+            {
+                Graphics g(image);
+                mips.draw(g, image.getBounds().toFloat(), Colours::black);
+            }
+            
+            expectGreaterThan(countCoveredPixels(image), 100);
+        }
+        
+        // A size the stream could never fill is rejected before its image is allocated
+        {
+            MemoryBlock corrupt(data);
+            corrupt[(int) getEntryOffset(0)] = (char) 0xff;
+            corrupt[(int) getEntryOffset(0) + 1] = (char) 0xff;
+            
+            const IconMipmaps mips(corrupt.getData(), corrupt.getSize());
+            expect(mips.isValid());
+            expect(mips.getMip(0).isNull());
+        }
+        
+        // Runs past the end of the source or the mask
+        uint8 mask[4];
+        const uint8 literalPastSource[] = {3, 1, 2};
+        const uint8 repeatPastMask[] = {(uint8) (257 - 5), 9};
+        const uint8 repeatWithoutValue[] = {(uint8) (257 - 4)};
+        const uint8 exact[] = {1, 7, 8, (uint8) (257 - 2), 9};
+        
+        expect(!IconMipmaps::decodeMask(literalPastSource, sizeof(literalPastSource), mask, sizeof(mask)));
+        expect(!IconMipmaps::decodeMask(repeatPastMask, sizeof(repeatPastMask), mask, sizeof(mask)));
+        expect(!IconMipmaps::decodeMask(repeatWithoutValue, sizeof(repeatWithoutValue), mask, sizeof(mask)));
+        expect(IconMipmaps::decodeMask(exact, sizeof(exact), mask, sizeof(mask)));
+        expect(mask[0] == 7 && mask[1] == 8 && mask[2] == 9 && mask[3] == 9);
+    }
+    
+    void testMisaligned()
+    {
+        beginTest("Tables at unaligned addresses");
+        
+        const auto data = buildMips();
+        const IconMipmaps original(data.getData(), data.getSize());
+        
+        for (size_t shift = 1; shift < 4; ++shift)
+        {
+            MemoryBlock shifted(data.getSize() + shift, true);
+            shifted.copyFrom(data.getData(), (int) shift, data.getSize());
+            
+            const IconMipmaps mips(static_cast<const uint8*>(shifted.getData()) + shift, data.getSize());
+            expect(mips.isValid());
+            
+            for (int i = 0; i < mips.getNumMips(); ++i)
+                expect(isSameImage(mips.getMip(i), original.getMip(i)));
+        }
+    }
+};
+
+static IconMipmapsTests iconMipmapsTests;
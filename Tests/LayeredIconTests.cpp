@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    Checks that LayeredIcon decodes the tables LayeredIconWriter wrote, and
+    rejects tables that are truncated, count past their data or hold bytes
+    that aren't verbs.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "LayeredIconWriter.h"
+
+//==============================================================================
+class LayeredIconTests: public UnitTest
+{
+public:
+    LayeredIconTests() : UnitTest("Layered icons", "Svg2Path") {}
+    
+    void runTest() override
+    {
+        testRoundTrip();
+        testTruncated();
+        testOutOfRangeCounts();
+        testCorruptVerbs();
+        testMisaligned();
+    }
+    
+private:
+    static MemoryBlock buildTable()
+    {
+        std::vector<SvgParser::Layer> layers(2);
+        
+        layers[0].shape.addRectangle(0.0f, 0.0f, 10.0f, 10.0f);
+        layers[0].colour = Colours::red;
+        
+        // A ring under even-odd, with a curve so the table holds more than primitives
+        layers[1].shape.addEllipse(2.0f, 2.0f, 6.0f, 6.0f);
+        layers[1].shape.startNewSubPath(4.0f, 4.0f);
+        layers[1].shape.cubicTo(5.0f, 3.0f, 6.0f, 5.0f, 6.0f, 6.0f);
+        layers[1].shape.lineTo(4.0f, 6.0f);
+        layers[1].shape.closeSubPath();
+        layers[1].colour = Colours::blue.withAlpha(0.5f);
+        layers[1].nonZeroWinding = false;
+        
+        return LayeredIconWriter::build(layers);
+    }
+    
+    static void put32(MemoryBlock& block, size_t offset, uint32 value)
+    {
+        for (int i = 0; i < 4; ++i)
+            block[(int) (offset + (size_t) i)] = (char) (value >> (8 * i));
+    }
+    
+    //! @brief the offset of the first layer's verbs, after its header and coords
+    static size_t getFirstVerbsOffset(const MemoryBlock& table)
+    {
+        const auto* bytes = static_cast<const uint8*>(table.getData());
+        const size_t layer = LayeredIcon::headerSize;
+        return layer + LayeredIcon::layerHeaderSize + ByteOrder::littleEndianInt(bytes + layer + 12) * sizeof(float);
+    }
+    
+    void expectSameLayers(const LayeredIcon& icon, const LayeredIcon& original)
+    {
+        expect(icon.isValid());
+        expectEquals(icon.getNumLayers(), original.getNumLayers());
+        expect(icon.getBounds() == original.getBounds());
+        
+        for (int i = 0; i < jmin(icon.getNumLayers(), original.getNumLayers()); ++i)
+        {
+            const auto& layer = icon.getLayer(i);
+            const auto& expected = original.getLayer(i);
+            expect(layer.colour == expected.colour);
+            expect(layer.path.isUsingNonZeroWinding() == expected.path.isUsingNonZeroWinding());
+            expect(layer.path.getBounds() == expected.path.getBounds());
+        }
+    }
+    
+    void testRoundTrip()
+    {
+        beginTest("Round trip");
+        
+        const auto table = buildTable();
+        const LayeredIcon icon(table.getData(), table.getSize());
+        expect(icon.isValid());
+        expectEquals(icon.getNumLayers(), 2);
+        expect(icon.getLayer(0).colour == Colours::red);
+        expect(icon.getLayer(0).path.isUsingNonZeroWinding());
+        expect(!icon.getLayer(1).path.isUsingNonZeroWinding());
+        expect(icon.getBounds() == Rectangle<float>(0.0f, 0.0f, 10.0f, 10.0f));
+    }
+    
+    void testTruncated()
+    {
+        beginTest("Truncated tables are rejected");
+        
+        const auto table = buildTable();
+        
+        // Copied, so reading past the end would be caught
+        for (size_t size = 0; size < table.getSize(); ++size)
+        {
+            MemoryBlock truncated(table.getData(), size);
+            const LayeredIcon icon(truncated.getData(), truncated.getSize());
+            expect(!icon.isValid(), "truncated to " + String((int) size));
+        }
+    }
+    
+    void testOutOfRangeCounts()
+    {
+        beginTest("Counts past the data are rejected");
+        
+        const auto table = buildTable();
+        const size_t layer = LayeredIcon::headerSize;
+        
+        auto expectRejected = [&](const String& name, const std::function<void(MemoryBlock&)>& edit) {
+            MemoryBlock corrupt(table);
+            edit(corrupt);
+            expect(!LayeredIcon(corrupt.getData(), corrupt.getSize()).isValid(), name);
+        };
+        
+        // Counts whose sizes overflow, run past the end, or disagree with the verbs
+        expectRejected("verbs", [&](MemoryBlock& b) { put32(b, layer + 8, 0xffffffffu); });
+        expectRejected("coords", [&](MemoryBlock& b) { put32(b, layer + 12, 0xffffffffu); });
+        expectRejected("coords overflowing", [&](MemoryBlock& b) { put32(b, layer + 12, 0x40000000u); });
+        expectRejected("coords not matching", [&](MemoryBlock& b) { put32(b, layer + 12, 2); });
+        expectRejected("layers", [&](MemoryBlock& b) { b[6] = 3; });
+        
+        // A different magic or version
+        expectRejected("magic", [](MemoryBlock& b) { b[0] = 0; });
+        expectRejected("version", [](MemoryBlock& b) { b[4] = 2; });
+    }
+    
+    void testCorruptVerbs()
+    {
+        beginTest("Bytes that aren't verbs are rejected");
+        
+        const auto table = buildTable();
+        const auto verbs = getFirstVerbsOffset(table);
+        
+        for (uint8 value: {(uint8) (ShapeData::ellipse + 1), (uint8) 0xff})
+        {
+            MemoryBlock corrupt(table);
+            corrupt[(int) verbs] = (char) value;
+            expect(!LayeredIcon(corrupt.getData(), corrupt.getSize()).isValid(), "verb " + String(value));
+        }
+        
+        // A real verb that takes a different number of coords
+        MemoryBlock corrupt(table);
+        corrupt[(int) verbs] = (char) ShapeData::roundedRectangle;
+        expect(!LayeredIcon(corrupt.getData(), corrupt.getSize()).isValid());
+    }
+    
+    void testMisaligned()
+    {
+        beginTest("Tables at unaligned addresses");
+        
+        const auto table = buildTable();
+        const LayeredIcon original(table.getData(), table.getSize());
+        
+        for (size_t shift = 1; shift < 4; ++shift)
+        {
+            MemoryBlock shifted(table.getSize() + shift, true);
+            shifted.copyFrom(table.getData(), (int) shift, table.getSize());
+            
+            const LayeredIcon icon(static_cast<const uint8*>(shifted.getData()) + shift, table.getSize());
+            expectSameLayers(icon, original);
+        }
+    }
+};
+
+static LayeredIconTests layeredIconTests;
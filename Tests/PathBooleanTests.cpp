@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    Checks that PathBoolean's unions and intersections fill the area their
+    operands cover, under the fill rule of each operand.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PathBoolean.h"
+
+//==============================================================================
+class PathBooleanTests: public UnitTest
+{
+public:
+    PathBooleanTests() : UnitTest("Path booleans", "Svg2Path") {}
+    
+    void runTest() override
+    {
+        testOverlappingUnion();
+        testNestedUnion();
+        testEvenOddOperand();
+        testCollinearEdges();
+        testIntersectionWithRectangle();
+    }
+    
+private:
+    static constexpr float tolerance = 0.001f;
+    
+    static ShapeData makeRectangle(float x1, float y1, float x2, float y2)
+    {
+        ShapeData shape;
+        shape.addRectangle(x1, y1, x2 - x1, y2 - y1);
+        return shape;
+    }
+    
+    static Path toPath(const ShapeData& shape, bool nonZeroWinding)
+    {
+        Path path;
+        shape.appendTo(path);
+        path.setUsingNonZeroWinding(nonZeroWinding);
+        return path;
+    }
+    
+    //! @brief checks the result's area, and that it fills where the reference does under either fill rule
+    void expectFills(const ShapeData& result, const std::function<bool(float, float)>& reference, float area)
+    {
+        expectWithinAbsoluteError(result.getSignedArea(tolerance), area, 0.05f);
+        
+        const auto nonZero = toPath(result, true);
+        const auto evenOdd = toPath(result, false);
+        
+        // The sample points stay more than a hundredth away from every outline
+        for (float y = -0.63f; y < 11.0f; y += 0.5f)
+        {
+            for (float x = -0.63f; x < 11.0f; x += 0.5f)
+            {
+                const bool filled = reference(x, y);
+                expectEquals(nonZero.contains(x, y, tolerance), filled);
+                expectEquals(evenOdd.contains(x, y, tolerance), filled);
+            }
+        }
+    }
+    
+    void testOverlappingUnion()
+    {
+        beginTest("Union of overlapping shapes");
+        
+        const auto a = makeRectangle(0.0f, 0.0f, 6.0f, 6.0f);
+        const auto b = makeRectangle(4.0f, 4.0f, 10.0f, 10.0f);
+        const auto result = PathBoolean::getUnion({a, b}, tolerance);
+        
+        expectFills(result, [](float x, float y) {
+            return (x < 6.0f && y < 6.0f && x > 0.0f && y > 0.0f) || (x > 4.0f && y > 4.0f && x < 10.0f && y < 10.0f);
+        }, 68.0f);
+        
+        // The outline goes around both, without the edges inside the other shape
+        expectEquals(PathBoolean::countEdges(result, tolerance), 8);
+    }
+    
+    void testNestedUnion()
+    {
+        beginTest("Union of nested shapes");
+        
+        // The inner shape turns the other way, which doesn't cut a hole in a union
+        auto inner = makeRectangle(3.0f, 3.0f, 7.0f, 7.0f);
+        inner.reverse();
+        const auto result = PathBoolean::getUnion({makeRectangle(0.0f, 0.0f, 10.0f, 10.0f), inner}, tolerance);
+        
+        expectFills(result, [](float x, float y) { return x > 0.0f && y > 0.0f && x < 10.0f && y < 10.0f; }, 100.0f);
+        expectEquals(PathBoolean::countEdges(result, tolerance), 4);
+    }
+    
+    void testEvenOddOperand()
+    {
+        beginTest("Even-odd operand");
+        
+        // Two contours turning the same way, a ring under even-odd and a square under non-zero
+        auto ring = makeRectangle(0.0f, 0.0f, 10.0f, 10.0f);
+        ring.append(makeRectangle(3.0f, 3.0f, 7.0f, 7.0f));
+        const auto clip = makeRectangle(2.0f, 2.0f, 8.0f, 8.0f);
+        
+        auto inClip = [](float x, float y) { return x > 2.0f && y > 2.0f && x < 8.0f && y < 8.0f; };
+        auto inHole = [](float x, float y) { return x > 3.0f && y > 3.0f && x < 7.0f && y < 7.0f; };
+        
+        expectFills(PathBoolean::getIntersection(ring, false, clip, true, tolerance),
+                    [&](float x, float y) { return inClip(x, y) && !inHole(x, y); }, 20.0f);
+        expectFills(PathBoolean::getIntersection(ring, true, clip, true, tolerance), inClip, 36.0f);
+        
+        // The rule applies to the clip as well
+        expectFills(PathBoolean::getIntersection(clip, true, ring, false, tolerance),
+                    [&](float x, float y) { return inClip(x, y) && !inHole(x, y); }, 20.0f);
+    }
+    
+    void testCollinearEdges()
+    {
+        beginTest("Collinear shared edges");
+        
+        // Shapes meeting along a whole edge, whose shared edge is dropped
+        {
+            const auto result = PathBoolean::getUnion({makeRectangle(0.0f, 0.0f, 5.0f, 10.0f),
+                                                       makeRectangle(5.0f, 0.0f, 10.0f, 10.0f)}, tolerance);
+            
+            expectFills(result, [](float x, float y) { return x > 0.0f && y > 0.0f && x < 10.0f && y < 10.0f; }, 100.0f);
+            
+            // The top and bottom may stay split where the shapes met
+            expectLessOrEqual(PathBoolean::countEdges(result, tolerance), 6);
+        }
+        
+        // Shapes overlapping along part of their top and bottom edges
+        {
+            const auto result = PathBoolean::getUnion({makeRectangle(0.0f, 0.0f, 6.0f, 4.0f),
+                                                       makeRectangle(2.0f, 0.0f, 8.0f, 4.0f)}, tolerance);
+            
+            expectFills(result, [](float x, float y) { return x > 0.0f && y > 0.0f && x < 8.0f && y < 4.0f; }, 32.0f);
+            expectLessOrEqual(PathBoolean::countEdges(result, tolerance), 8);
+        }
+        
+        // An intersection along the clip's edge
+        {
+            const auto result = PathBoolean::getIntersection(makeRectangle(0.0f, 0.0f, 6.0f, 4.0f), true,
+                                                             makeRectangle(0.0f, 0.0f, 4.0f, 4.0f), true, tolerance);
+            
+            expectFills(result, [](float x, float y) { return x > 0.0f && y > 0.0f && x < 4.0f && y < 4.0f; }, 16.0f);
+        }
+    }
+    
+    void testIntersectionWithRectangle()
+    {
+        beginTest("Intersection with a rectangle");
+        
+        // A circle centred on (5, 5) clipped to its right half
+        ShapeData circle;
+        circle.addEllipse(1.4f, 1.4f, 7.2f, 7.2f);
+        const auto clip = makeRectangle(5.0f, -1.0f, 11.0f, 11.0f);
+        const auto result = PathBoolean::getIntersection(circle, true, clip, true, tolerance);
+        
+        const auto circlePath = toPath(circle, true);
+        expectFills(result, [&](float x, float y) { return x > 5.0f && circlePath.contains(x, y, tolerance); },
+                    MathConstants<float>::pi * 3.6f * 3.6f * 0.5f);
+    }
+};
+
+static PathBooleanTests pathBooleanTests;
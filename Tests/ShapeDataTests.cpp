@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    Checks that orienting a shape's contours keeps the area it fills and lets
+    shapes appended to it add up under non-zero winding.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "ShapeData.h"
+
+//==============================================================================
+class ShapeDataTests: public UnitTest
+{
+public:
+    ShapeDataTests() : UnitTest("Shape data", "Svg2Path") {}
+    
+    void runTest() override
+    {
+        testOrientContours();
+    }
+    
+private:
+    //! @brief adds a rectangle turning the way Path::addRectangle does, or the other way
+    static void addRectangle(ShapeData& shape, float x1, float y1, float x2, float y2, bool positive)
+    {
+        shape.startNewSubPath(x1, y1);
+        
+        if (positive)
+        {
+            shape.lineTo(x2, y1);
+            shape.lineTo(x2, y2);
+            shape.lineTo(x1, y2);
+        }
+        else
+        {
+            shape.lineTo(x1, y2);
+            shape.lineTo(x2, y2);
+            shape.lineTo(x2, y1);
+        }
+        
+        shape.closeSubPath();
+    }
+    
+    static Path toPath(const ShapeData& shape, bool nonZeroWinding)
+    {
+        Path path;
+        shape.appendTo(path);
+        path.setUsingNonZeroWinding(nonZeroWinding);
+        return path;
+    }
+    
+    void expectSameFill(const ShapeData& original, bool nonZeroWinding)
+    {
+        auto oriented = original;
+        oriented.orientContours(nonZeroWinding, 0.01f);
+        
+        // A shape that overlaps everything, appended after orienting, must not cancel any of it
+        ShapeData other;
+        addRectangle(other, 2.5f, -1.0f, 11.0f, 11.0f, true);
+        auto merged = oriented;
+        merged.append(other);
+        
+        const auto before = toPath(original, nonZeroWinding);
+        const auto after = toPath(oriented, true);
+        const auto mergedPath = toPath(merged, true);
+        const auto otherPath = toPath(other, true);
+        
+        // The sample points stay more than a hundredth away from every outline
+        const float tolerance = 0.001f;
+        
+        for (float y = -0.71f; y < 11.0f; y += 0.5f)
+        {
+            for (float x = -0.63f; x < 11.0f; x += 0.5f)
+            {
+                const bool filled = before.contains(x, y, tolerance);
+                expectEquals(after.contains(x, y, tolerance), filled);
+                expectEquals(mergedPath.contains(x, y, tolerance), filled || otherPath.contains(x, y, tolerance));
+            }
+        }
+    }
+    
+    void testOrientContours()
+    {
+        beginTest("Orient contours");
+        
+        // An even-odd hole turning the same way as its outline
+        {
+            ShapeData shape;
+            addRectangle(shape, 0.0f, 0.0f, 10.0f, 10.0f, true);
+            addRectangle(shape, 3.0f, 3.0f, 7.0f, 7.0f, true);
+            expectSameFill(shape, false);
+        }
+        
+        // A non-zero hole in an outline turning the other way
+        {
+            ShapeData shape;
+            addRectangle(shape, 0.0f, 0.0f, 10.0f, 10.0f, false);
+            addRectangle(shape, 3.0f, 3.0f, 7.0f, 7.0f, true);
+            expectSameFill(shape, true);
+        }
+        
+        // Nested contours with the fill on both sides of some of them
+        {
+            ShapeData shape;
+            addRectangle(shape, 0.0f, 0.0f, 10.0f, 10.0f, false);
+            addRectangle(shape, 2.0f, 2.0f, 8.0f, 8.0f, false);
+            addRectangle(shape, 3.0f, 3.0f, 7.0f, 7.0f, true);
+            addRectangle(shape, 4.0f, 4.0f, 6.0f, 6.0f, true);
+            expectSameFill(shape, true);
+        }
+        
+        // Overlapping and separate contours turning opposite ways
+        {
+            ShapeData shape;
+            addRectangle(shape, 0.0f, 0.0f, 6.0f, 6.0f, false);
+            addRectangle(shape, 4.0f, 4.0f, 10.0f, 10.0f, false);
+            addRectangle(shape, 7.0f, 0.0f, 10.0f, 3.0f, true);
+            expectSameFill(shape, true);
+        }
+        
+        // Ellipses are expanded into curves before they are turned
+        {
+            ShapeData shape;
+            shape.addEllipse(0.0f, 0.0f, 10.0f, 10.0f);
+            shape.addEllipse(3.0f, 3.0f, 3.5f, 3.5f);
+            expectSameFill(shape, false);
+        }
+    }
+};
+
+static ShapeDataTests shapeDataTests;
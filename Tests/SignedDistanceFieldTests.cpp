@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    Checks that signed distance fields from SdfGenerator draw the same coverage
+    as filling their path with Graphics::fillPath.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SdfGenerator.h"
+
+//==============================================================================
+class SignedDistanceFieldTests: public UnitTest
+{
+public:
+    SignedDistanceFieldTests() : UnitTest("Signed distance fields", "Svg2Path") {}
+    
+    void runTest() override
+    {
+        testHeader();
+        testCubicDistance();
+        testAgainstFillPath();
+    }
+    
+private:
+    //! @brief the largest and mean coverage difference between two single channel images
+    struct Difference
+    {
+        float maxError;
+        float meanError;
+    };
+    
+    // The field's edge is a linear ramp over a pixel, where the software renderer measures the
+    // covered area, so even a smooth outline differs by a few percent along the edge. Corners are
+    // rounded off by the field, so only smooth shapes are held to these bounds.
+    static constexpr float maxErrorBound = 0.25f;
+    static constexpr float meanErrorBound = 0.01f;
+    
+    static Image fillPath(const Path& path, int pixelSize)
+    {
+        Image image(Image::SingleChannel, pixelSize, pixelSize, true, SoftwareImageType());
+        
+        Graphics g(image);
+        g.setColour(Colours::white);
+        g.fillPath(path, AffineTransform::scale((float) pixelSize));
+        
+        return image;
+    }
+    
+    static Difference getDifference(const Image& a, const Image& b)
+    {
+        const Image::BitmapData first(a, Image::BitmapData::readOnly);
+        const Image::BitmapData second(b, Image::BitmapData::readOnly);
+        
+        Difference result{0.0f, 0.0f};
+        double total = 0.0;
+        
+        for (int y = 0; y < first.height; ++y)
+        {
+            for (int x = 0; x < first.width; ++x)
+            {
+                const float error = std::abs((float) first.getPixelPointer(x, y)[0] - (float) second.getPixelPointer(x, y)[0]) / 255.0f;
+                result.maxError = jmax(result.maxError, error);
+                total += error;
+            }
+        }
+        
+        result.meanError = (float) (total / (first.width * first.height));
+        return result;
+    }
+    
+    void testHeader()
+    {
+        beginTest("Header");
+        
+        Path circle;
+        circle.addEllipse(0.2f, 0.2f, 0.6f, 0.6f);
+        const auto field = SdfGenerator(32, 3.0f).build(circle);
+        
+        const SignedDistanceField sdf(field.getData(), field.getSize());
+        expect(sdf.isValid());
+        expectEquals(sdf.getSize(), 32);
+        expectEquals(sdf.getSpread(), 3.0f);
+        expectEquals(field.getSize(), SignedDistanceField::headerSize + 32 * 32);
+        
+        // The centre is inside and a corner of the unit square is outside
+        expectGreaterThan(sdf.getDistance(0.5f, 0.5f), 0.0f);
+        expectLessThan(sdf.getDistance(0.0f, 0.0f), 0.0f);
+        
+        // Truncated data and a wrong magic are rejected
+        expect(!SignedDistanceField(field.getData(), field.getSize() - 1).isValid());
+        
+        MemoryBlock corrupt(field);
+        corrupt[0] = 0;
+        expect(!SignedDistanceField(corrupt.getData(), corrupt.getSize()).isValid());
+    }
+    
+    //! @brief the distance to the closest of many evenly spaced points on a cubic, with the most it
+    //! can be above the true distance
+    static std::pair<float, float> getSampledDistance(const Point<float>* points, Point<float> p)
+    {
+        constexpr int numSamples = 8192;
+        float distance = std::numeric_limits<float>::max();
+        
+        for (int i = 0; i <= numSamples; ++i)
+        {
+            const double t = (double) i / numSamples, mt = 1.0 - t;
+            const double x = points[0].x * mt * mt * mt + points[1].x * 3.0 * mt * mt * t
+                           + points[2].x * 3.0 * mt * t * t + points[3].x * t * t * t;
+            const double y = points[0].y * mt * mt * mt + points[1].y * 3.0 * mt * mt * t
+                           + points[2].y * 3.0 * mt * t * t + points[3].y * t * t * t;
+            distance = jmin(distance, (float) std::hypot(x - p.x, y - p.y));
+        }
+        
+        // Neighbouring samples are no further apart than a step along the control polygon
+        const float length = points[0].getDistanceFrom(points[1]) + points[1].getDistanceFrom(points[2])
+                           + points[2].getDistanceFrom(points[3]);
+        return {distance, 0.5f * length / numSamples};
+    }
+    
+    void testCubicDistance()
+    {
+        beginTest("Cubic distance is within its bound of a dense sampling");
+        
+        // Room for float rounding on top of the stated bound
+        const float slack = 1.0e-4f;
+        
+        std::vector<std::array<Point<float>, 4>> cubics = {
+            {{{0.0f, 0.0f}, {64.0f, 64.0f}, {0.0f, 64.0f}, {64.0f, 0.0f}}},     // a loop
+            {{{0.0f, 32.0f}, {64.0f, 0.0f}, {0.0f, 0.0f}, {64.0f, 32.0f}}},     // a cusp
+            {{{8.0f, 8.0f}, {8.0f, 8.0f}, {56.0f, 56.0f}, {56.0f, 56.0f}}},     // a line
+            {{{32.0f, 32.0f}, {32.0f, 32.0f}, {32.0f, 32.0f}, {32.0f, 32.0f}}}  // a point
+        };
+        
+        Random random(2024);
+        auto randomPoint = [&random](float range) {
+            return Point<float>(random.nextFloat() * range, random.nextFloat() * range);
+        };
+        
+        for (int i = 0; i < 40; ++i)
+            cubics.push_back({randomPoint(64.0f), randomPoint(64.0f), randomPoint(64.0f), randomPoint(64.0f)});
+        
+        for (const auto& cubic: cubics)
+        {
+            for (int i = 0; i < 50; ++i)
+            {
+                const auto p = randomPoint(80.0f) - Point<float>(8.0f, 8.0f);
+                const auto distance = SdfGenerator::getDistanceToCubic(cubic.data(), p);
+                const auto sampled = getSampledDistance(cubic.data(), p);
+                
+                // The sampled distance is never below the true one, and at most its spacing above it
+                expectLessOrEqual(distance, sampled.first + SdfGenerator::maxCubicDistanceError + slack);
+                expectGreaterOrEqual(distance, sampled.first - sampled.second - SdfGenerator::maxCubicDistanceError - slack);
+            }
+        }
+    }
+    
+    void testAgainstFillPath()
+    {
+        Path circle;
+        circle.addEllipse(0.15f, 0.15f, 0.7f, 0.7f);
+        
+        Path ring;
+        ring.addEllipse(0.1f, 0.1f, 0.8f, 0.8f);
+        ring.addEllipse(0.28f, 0.28f, 0.44f, 0.44f);
+        ring.setUsingNonZeroWinding(false);
+        
+        Path roundedRectangle;
+        roundedRectangle.addRoundedRectangle(0.15f, 0.2f, 0.7f, 0.6f, 0.15f);
+        
+        const std::pair<const char*, const Path*> shapes[] = {
+            {"circle", &circle}, {"ring", &ring}, {"rounded rectangle", &roundedRectangle}};
+        
+        for (const auto& shape: shapes)
+        {
+            beginTest(String("Render matches fillPath: ") + shape.first);
+            
+            const auto field = SdfGenerator().build(*shape.second);
+            const SignedDistanceField sdf(field.getData(), field.getSize());
+            expect(sdf.isValid());
+            
+            for (int pixelSize: {16, 32, 64, 128})
+            {
+                const auto difference = getDifference(sdf.render(pixelSize), fillPath(*shape.second, pixelSize));
+                const String size = " at " + String(pixelSize) + "px";
+                
+                expectLessOrEqual(difference.maxError, maxErrorBound, "max error" + size);
+                expectLessOrEqual(difference.meanError, meanErrorBound, "mean error" + size);
+                
+                // compare() is what the CLI reports, it has to measure the same thing
+                const auto comparison = SdfGenerator::compare(*shape.second, field, pixelSize);
+                expectWithinAbsoluteError(comparison.maxError, difference.maxError, 1.0e-6f);
+                expectWithinAbsoluteError(comparison.meanError, difference.meanError, 1.0e-6f);
+            }
+        }
+    }
+};
+
+static SignedDistanceFieldTests signedDistanceFieldTests;
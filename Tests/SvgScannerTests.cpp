@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+    Checks that SvgScanner skips everything but tags, decodes attribute
+    values, and that svgs it can't read are rejected by SvgParser.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SvgParser.h"
+#include "SvgScanner.h"
+
+//==============================================================================
+class SvgScannerTests: public UnitTest
+{
+public:
+    SvgScannerTests() : UnitTest("Svg scanner", "Svg2Path") {}
+    
+    void runTest() override
+    {
+        testSkippedMarkup();
+        testEntities();
+        testMalformed();
+        testClipPathsAfterUse();
+        testDeepNesting();
+    }
+    
+private:
+    //! @brief lists the tags of some svg text as <name>, <name/> and </name>, ending with "error" if it stopped early
+    static String scan(const char* text)
+    {
+        SvgScanner scanner(text, std::strlen(text));
+        StringArray tokens;
+        
+        for (auto token = scanner.next(); token != SvgScanner::Token::end; token = scanner.next())
+        {
+            if (token == SvgScanner::Token::error)
+            {
+                tokens.add("error");
+                break;
+            }
+            
+            if (token == SvgScanner::Token::endTag)
+                tokens.add("</" + scanner.getTagName() + ">");
+            else
+                tokens.add("<" + scanner.getTagName() + (scanner.isEmptyElement() ? "/>" : ">"));
+        }
+        
+        return tokens.joinIntoString(" ");
+    }
+    
+    static SvgParser::Conversion convert(const char* text, bool applyClipPaths = false)
+    {
+        SvgParser::Options options;
+        options.applyClipPaths = applyClipPaths;
+        return SvgParser::convert(text, std::strlen(text), options);
+    }
+    
+    void testSkippedMarkup()
+    {
+        beginTest("Comments, CDATA, processing instructions and the doctype are skipped");
+        
+        expectEquals(scan("<svg><!-- <path d=\"M0 0\"/> -> > --><path/></svg>"), String("<svg> <path/> </svg>"));
+        expectEquals(scan("<svg><style><![CDATA[ a > b </style> ]]></style></svg>"),
+                     String("<svg> <style> </style> </svg>"));
+        expectEquals(scan("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                          "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" \"svg11.dtd\" [\n"
+                          "  <!ENTITY shape \"<rect width='1' height='1'/>\">\n"
+                          "  <!ENTITY % parameter \"ignored\">\n"
+                          "]>\n"
+                          "<svg>text &amp; more text<g/></svg>"),
+                     String("<svg> <g/> </svg>"));
+        
+        // A byte order mark before the prolog
+        expectEquals(scan("\xef\xbb\xbf<svg/>"), String("<svg/>"));
+    }
+    
+    void testEntities()
+    {
+        beginTest("Entities in attribute values");
+        
+        const char text[] = "<path id=\"a&amp;b&lt;&gt;&quot;&apos;&#65;&#x42;&unknown;&amp\" d='M0 0'/>";
+        SvgScanner scanner(text, sizeof(text) - 1);
+        expect(scanner.next() == SvgScanner::Token::startTag);
+        
+        const auto element = scanner.takeElement();
+        expectEquals(element->getStringAttribute("id"), String("a&b<>\"'AB&unknown;&amp"));
+        expectEquals(element->getStringAttribute("d"), String("M0 0"));
+        
+        // Multibyte characters pass through, as utf-8 or as numeric references
+        const char value[] = "\xc3\xa9&#233;&#xe9;";
+        const String decoded = SvgScanner::decodeEntities(value, value + sizeof(value) - 1);
+        expectEquals(decoded, String(CharPointer_UTF8("\xc3\xa9\xc3\xa9\xc3\xa9")));
+    }
+    
+    void testMalformed()
+    {
+        beginTest("Mismatched tags and truncated input are rejected");
+        
+        const char* const validPath = "<path d=\"M0 0L1 1L1 0Z\"/>";
+        
+        expect(convert((String("<svg>") + validPath + "</svg>").toRawUTF8()).wasSuccessful());
+        
+        // Mismatched and unbalanced tags
+        for (auto* text: {"<svg><g><path d=\"M0 0L1 1L1 0Z\"/></svg></g>",
+                          "<svg><path d=\"M0 0L1 1L1 0Z\"/></g></svg>",
+                          "<svg><path d=\"M0 0L1 1L1 0Z\"/></svg><svg/>"})
+        {
+            expect(!convert(text).wasSuccessful(), text);
+        }
+        
+        // Input that ends inside a tag, an attribute value, a comment, a CDATA section or the doctype
+        expectEquals(scan("<svg><path d=\"M0 0"), String("<svg> error"));
+        expectEquals(scan("<svg><path d=\"M0 0\""), String("<svg> error"));
+        expectEquals(scan("<svg></svg"), String("<svg> error"));
+        expectEquals(scan("<svg><!-- comment"), String("<svg> error"));
+        expectEquals(scan("<svg><![CDATA[ data"), String("<svg> error"));
+        expectEquals(scan("<!DOCTYPE svg [ <!ENTITY a \"b\"> <svg/>"), String("error"));
+        
+        // Input that ends between tags, with elements left open
+        for (auto* text: {"<svg><path d=\"M0 0L1 1L1 0Z\"/>", "<svg><path d=\"M0 0", "", "<!-- only a comment -->"})
+            expect(!convert(text).wasSuccessful(), text);
+    }
+    
+    void testClipPathsAfterUse()
+    {
+        beginTest("Clip paths defined after the elements using them");
+        
+        // The clipPath comes last, as some editors write it
+        const char text[] = "<svg viewBox=\"0 0 10 10\">"
+                            "<rect width=\"10\" height=\"10\" clip-path=\"url(#left)\"/>"
+                            "<defs><clipPath id=\"left\"><rect width=\"4\" height=\"10\"/></clipPath></defs>"
+                            "</svg>";
+        
+        const auto scanned = convert(text, true);
+        expect(scanned.wasSuccessful());
+        expectWithinAbsoluteError(scanned.path.getBounds().getWidth(), 4.0f, 0.001f);
+        
+        // The tree is read the same way
+        SvgParser::Options options;
+        options.applyClipPaths = true;
+        const auto parsed = SvgParser::convert(String(text), options);
+        expect(parsed.wasSuccessful());
+        expect(parsed.path.getBounds() == scanned.path.getBounds());
+    }
+    
+    void testDeepNesting()
+    {
+        beginTest("Deeply nested groups");
+        
+        // Deep enough to overflow the call stack of anything that recurses once per level
+        const int depth = 50000;
+        const String path = "<path d=\"M0 0L1 1L1 0Z\"/>";
+        
+        for (auto* wrapper: {"", "<defs>"})
+        {
+            const String opening = wrapper;
+            const String closing = opening.isEmpty() ? String() : opening.replace("<", "</");
+            
+            String svg;
+            svg.preallocateBytes((size_t) depth * 8 + 256);
+            svg << "<svg>" << opening;
+            
+            for (int i = 0; i < depth; ++i)
+                svg << "<g>";
+            
+            svg << path;
+            
+            for (int i = 0; i < depth; ++i)
+                svg << "</g>";
+            
+            // The shape in the definitions isn't drawn, so that svg needs one outside them
+            svg << closing << (opening.isEmpty() ? String() : path) << "</svg>";
+            
+            const auto fromString = SvgParser::convert(svg, SvgParser::Options());
+            expect(fromString.wasSuccessful(), fromString.error);
+            expectEquals(fromString.path.getBounds().getWidth(), 1.0f);
+            
+            const auto fromData = convert(svg.toRawUTF8());
+            expect(fromData.wasSuccessful(), fromData.error);
+            expectEquals(fromData.path.getBounds().getWidth(), 1.0f);
+        }
+    }
+};
+
+static SvgScannerTests svgScannerTests;
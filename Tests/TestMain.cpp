@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    Runs the unit tests of the converter and the runtime readers, and fails the
+    process if any of them fail.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    ArgumentList args(argc, argv);
+    
+    UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    
+    // --test <name> runs one test, e.g. "Arc approximation"
+    if (args.containsOption("--test"))
+    {
+        Array<UnitTest*> tests;
+        for (auto* test: UnitTest::getAllTests())
+            if (test->getName() == args.getValueForOption("--test"))
+                tests.add(test);
+        
+        runner.runTests(tests);
+    }
+    else
+    {
+        runner.runTestsInCategory("Svg2Path");
+    }
+    
+    int numFailures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+    
+    return runner.getNumResults() > 0 && numFailures == 0 ? 0 : 1;
+}